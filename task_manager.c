@@ -2,25 +2,86 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdatomic.h>
 
 // Include pthread.h before time.h to avoid redefinition issues
 #include <pthread.h>
 #include <time.h>
+#include <signal.h>
 
 #include <stdbool.h>
 
 // Cross-platform sleep function
 #ifdef _WIN32
     #include <windows.h>
+    #include <io.h>
     #define sleep(x) Sleep((x)*1000)
 #else
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
 #endif
 
-#define MAX_TASKS 100
+// SSE2/AVX2 substring kernels, chosen at runtime (GCC/Clang on x86 only)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define HAVE_X86_SIMD 1
+#endif
+
+#define INITIAL_TASK_CAPACITY 16
 #define MAX_DESCRIPTION 256
 #define FILENAME "tasks.dat"
-#define MAX_SIMULTANEOUS_TASKS 10
+#define SNAPSHOT_TEMP_FILENAME "tasks.dat.tmp"
+#define JOURNAL_FILENAME "tasks.journal"
+#define JOURNAL_CHECKPOINT_MIN 1024
+#define JOURNAL_HEADER_SIZE 12   // u32 type, u32 payload bytes, u32 CRC32C of both and payload
+// Set to 0 to read tasks.dat into a buffer instead of decoding it from a
+// read-only mapping. Either way every task is decoded into the heap columns
+// at load, so this only changes where the bytes are read from (it saves the
+// copy into a buffer); startup still grows with the file.
+#define MMAP_STORAGE 1
+// tasks.dat format: a header, then CRC32C-checked blocks of encoded tasks
+#define SNAPSHOT_MAGIC "TMGR"
+#define SNAPSHOT_VERSION 2   // 2 added the dependency section
+#define SNAPSHOT_HEADER_SIZE 24
+#define SNAPSHOT_BLOCK_HEADER_SIZE 12
+#define SNAPSHOT_BLOCK_TASKS 4096
+#define TASK_RECORD_MAX (32 + MAX_DESCRIPTION)   // worst-case encoded task
+#define MAX_EXECUTOR_WORKERS 256
+#define WORK_DEQUE_MIN_CAPACITY 64
+#define DISPATCH_LEVELS 3   // one deque per priority per worker
+#define WORK_EMPTY -1       // deque had no job
+#define WORK_ABORT -2       // lost a race for the job; try again
+#define SCHEDULE_POLICY_COUNT 5
+#define PLAN_TIMELINE_PREVIEW 4   // jobs listed per worker in a printed plan
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4      // 64^4 ticks, about 194 days of one-second ticks
+#define MAX_TIMER_SLOTS 1000000   // tasks the timer wheel may run at once
+#define SIMULATION_EVENT_PREVIEW 20   // completions listed by a simulated run
+#define TASK_LINE_MAX (MAX_DESCRIPTION + 32)   // longest import record kept whole
+#define STREAM_BUFFER_SIZE (1 << 20)   // read-ahead of imports and exports
+#define IMPORT_ERROR_PREVIEW 10   // malformed import lines reported one by one
+#define BATCH_MAX_WORDS 64
+#define CSV_MAX_COLUMNS 64
+#define CSV_HEADER_NAME_MAX 64
+#define EXPORT_ROW_MAX (6 * MAX_DESCRIPTION + 128)   // longest exported line, all escapes
+#define GROUP_COMMIT_RECORDS 256      // waiting completions that start a commit early
+#define GROUP_COMMIT_INTERVAL_MS 50   // longest a completion waits to be made durable
+#define INITIAL_INDEX_CAPACITY 64
+#define CREATED_INSERT_SCAN 64   // entries an insert may shift before leaving the sort for later
+#define COMPACT_MIN_DELETED 1024
+#define SORT_INSERTION_CUTOFF 32
+#define PARALLEL_SORT_THRESHOLD 65536
+#define PARALLEL_LOAD_THRESHOLD 65536   // tasks before a load or index rebuild fans out
+#define TRIGRAM_EMPTY 0xFFFFFFFFu
+#define INITIAL_ARENA_CAPACITY 4096
+#define ARENA_COMPACT_MIN_STALE 65536
+// Set to 1 to treat tasks as duplicates only when priority and duration match too
+#define DUPLICATE_KEY_INCLUDES_SCHEDULE 0
 
 typedef enum {
     LOW = 5,
@@ -37,25 +98,641 @@ typedef struct {
     bool completed;
 } Task;
 
+// Orderings shared by the Sort Tasks menu and the sequential executor
+typedef enum {
+    SORT_BY_PRIORITY = 1,   // priority, then duration
+    SORT_BY_DURATION = 2,   // duration, then priority
+    SORT_BY_CREATED = 3     // newest first
+} SortKey;
+
+typedef struct {
+    int *slots;
+    int *scratch;
+    int count;
+    SortKey key;
+} SortRange;
+
+typedef struct {
+    const int *left;
+    int leftCount;
+    const int *right;
+    int rightCount;
+    int *out;
+    SortKey key;
+} MergeRange;
+
+// One task handed to an executor worker
+typedef struct {
+    Task task;          // copy taken when the job is queued
+    int slot;
+} ExecutionJob;
+
+// Order in which a parallel run hands out its jobs
+typedef enum {
+    POLICY_FIFO = 1,        // list order
+    POLICY_PRIORITY = 2,    // High first, list order within a priority
+    POLICY_SJF = 3,         // shortest first: lowest mean completion time
+    POLICY_LPT = 4,         // longest first: shortest makespan
+    POLICY_WEIGHTED = 5     // least duration per unit of priority weight first
+} SchedulePolicy;
+
+// Predicted schedule of a batch, worked out from the known durations: each
+// time a worker frees up it starts the first ready job in policy order
+typedef struct {
+    SchedulePolicy policy;
+    int workers;
+    int count;
+    int *order;             // job indexes in order of predicted start
+    int *worker;            // per job: the worker it is dealt to
+    long long *start;       // per job: predicted start, seconds into the run
+    long long makespan;
+    long long highMakespan; // when the last High job is predicted to finish
+    double meanCompletion;
+} SchedulePlan;
+
+// `task` may only start once `prerequisite` has completed
+typedef struct {
+    int task;
+    int prerequisite;
+} DependencyEdge;
+
+// Precedence among the jobs of one batch, as successor lists: the jobs
+// waiting on job j are successors[successorStart[j] .. successorStart[j + 1])
+typedef struct {
+    int *successorStart;
+    int *successors;
+    int *predecessorCount;      // per job: prerequisites inside the batch
+    int edgeCount;
+    long long criticalLength;   // longest chain of durations through the batch
+    int *criticalPath;          // job indexes along that chain, first to last
+    int criticalCount;
+} JobGraph;
+
+// A job's position under a policy; sorting these gives the dispatch order
+typedef struct {
+    long long key;
+    int job;
+} PlanKey;
+
+// Planning heap entry: a worker and when it frees up, a running job and
+// when it finishes, or a ready job and its rank in policy order
+typedef struct {
+    long long time;
+    int id;
+} TimedEntry;
+
+// Hierarchical timing wheel holding one timer per running job. Level 0 has a
+// slot per tick for the next 64 ticks; each level above spans 64 times the
+// one below and is cascaded down as its time comes round, so a tick costs
+// O(1) and a timer moves at most TIMER_WHEEL_LEVELS - 1 times before it fires.
+typedef struct {
+    long long now;      // last tick advanced to
+    int heads[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];   // first job in each slot, -1 if none
+    int *next;          // per job: next job in the same slot
+    long long *expires; // per job: tick its timer fires
+} TimerWheel;
+
+// Called by the timer engine when jobs[job] starts and when it finishes, at `tick`
+typedef void (*TimerEvent)(const ExecutionJob *jobs, int job, long long tick, bool finished);
+
+// Life of a job in a batch. Each step is one atomic transition, so a job
+// runs at most once and how it ended is published exactly once.
+typedef enum {
+    JOB_PENDING = 0,
+    JOB_RUNNING = 1,
+    JOB_DONE = 2,
+    JOB_CANCELLED = 3   // never started, or stopped before its countdown ran out
+} JobState;
+
+// Request to stop a run, shared by every thread taking part in it. Setting
+// it is a single lock-free store, so a signal handler may do it.
+typedef struct {
+    atomic_bool requested;
+} CancelToken;
+
+// Jobs of a batch in the order they completed. A worker claims the next
+// position with one fetch-add and then writes its job there; a reader only
+// trusts positions already written. No lock on either side.
+typedef struct {
+    _Atomic int *entries;   // job index per position, -1 until written
+    _Atomic int claimed;    // positions handed out so far
+    int capacity;
+    struct GroupCommit *committer;  // woken when a group is ready, may be NULL
+} CompletionLog;
+
+// Background journal writer for a run. It follows the run's completion log
+// and commits whatever has arrived as one group: a journal record per
+// completion, then a single fsync. A group goes out once
+// GROUP_COMMIT_RECORDS are waiting or GROUP_COMMIT_INTERVAL_MS has passed.
+// Only this thread writes the journal while the run lasts.
+typedef struct GroupCommit {
+    pthread_t thread;
+    CompletionLog *log;
+    const ExecutionJob *jobs;
+    _Atomic int committed;  // log positions already durable
+    atomic_bool stopping;
+    int groups;             // fsyncs issued
+    bool failed;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+} GroupCommit;
+
+// Circular array behind a work deque; replaced buffers stay on the
+// `previous` chain until the batch ends, since a thief may still read one
+typedef struct WorkBuffer {
+    long long capacity;     // power of two
+    struct WorkBuffer *previous;
+    _Atomic int items[];
+} WorkBuffer;
+
+// Chase-Lev work-stealing deque of job indexes. The owning worker pushes and
+// takes at the bottom with no lock; other workers steal from the top, and
+// only a race for the same job needs a compare-and-swap.
+typedef struct {
+    _Atomic long long top;
+    _Atomic long long bottom;
+    WorkBuffer *_Atomic buffer;
+} WorkDeque;
+
+// Long-lived executor threads, each with a deque of jobs per priority. A
+// worker runs its own jobs and, once out, steals from the others, so it picks
+// up new work the moment it finishes a job. Higher priorities are drained
+// across all workers before a lower one is touched. When jobs depend on each
+// other only the ready ones are dealt; each finished job counts down the jobs
+// waiting on it and pushes those it frees onto its own deque, while workers
+// with nothing to do sleep until a job is released. A job's state moves
+// pending -> running -> done or cancelled by atomic transitions, and workers
+// publish completions to a lock-free log instead of writing the task store,
+// which only the thread that started the batch touches. Threads are only
+// created when the pool starts or changes size, never per task.
+typedef struct {
+    pthread_t *threads;
+    int workerCount;
+    WorkDeque *deques;      // DISPATCH_LEVELS per worker, see workerDeque()
+    ExecutionJob *jobs;     // current batch, owned by the caller of executeBatch()
+    _Atomic int unfinished; // jobs of the batch not yet done
+    _Atomic long long steals;
+    int batch;              // bumped for every batch
+    bool batchOpen;         // workers may join the current batch
+    int activeWorkers;      // workers inside the current batch
+    bool stealing;          // false pins every job to the worker it was dealt to
+    bool priorityLevels;    // deal each priority to its own level, else all to level 0
+    const JobGraph *graph;  // current batch's dependencies, NULL if its jobs are independent
+    _Atomic int *waitingOn; // per job: prerequisites still running or queued
+    _Atomic int releases;   // bumped whenever a finished job frees others
+    _Atomic int *jobStates; // per job: its JobState
+    CompletionLog *completions; // where finished jobs are published, may be NULL
+    bool shutdown;
+    bool (*runJob)(int worker, const ExecutionJob *job);   // false if cancelled part way
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t batchDone;
+    pthread_cond_t jobsReleased;
+} ExecutorPool;
+
+// Unordered set of slots with O(1) insert/remove; positions live in a per-slot array
+typedef struct {
+    int *slots;
+    int count;
+    int capacity;
+} SlotSet;
+
+// Created-time index entry; keyed by ID so it survives slots moving
+typedef struct {
+    time_t created;
+    int id;
+} CreatedEntry;
+
+// A snapshot block found by walking the block headers ahead of decoding
+typedef struct {
+    const unsigned char *start;   // first encoded task
+    unsigned int tasks;
+    unsigned int bytes;
+    unsigned int crc;
+    int firstSlot;                // slot of its first task
+    bool valid;                   // CRC matched and every task decoded
+} SnapshotBlock;
+
+// Where a decoded task's description sits in the snapshot, with its intern hash
+typedef struct {
+    const unsigned char *text;
+    unsigned int length;
+    unsigned int hash;
+} DescriptionRef;
+
+// Blocks shared out to the decoding threads of a parallel load
+typedef struct {
+    SnapshotBlock *blocks;
+    int blockCount;
+    _Atomic int nextBlock;        // next block for a thread to claim
+    DescriptionRef *descriptions; // per slot
+} SnapshotDecode;
+
+// One thread's share of a parallel index rebuild: a slot range, what it
+// counted, and where its members go in each index
+typedef struct {
+    int first;
+    int end;
+    int inserted;                 // IDs added to the ID index
+    int bucketCounts[3];
+    int pendingCount;
+    int bucketStart[3];
+    int pendingStart;
+    int createdStart;
+    bool fillCreated;             // also write and sort created-time entries
+} IndexRange;
+
+typedef struct {
+    const CreatedEntry *left;
+    int leftCount;
+    const CreatedEntry *right;
+    int rightCount;
+    CreatedEntry *out;
+} CreatedMerge;
+
+// Journal record types. Every record is idempotent, so replaying a journal
+// over a snapshot that already contains some of its changes is harmless.
+typedef enum {
+    JOURNAL_ADD = 1,        // payload: encoded task (encodeTaskRecord)
+    JOURNAL_UPDATE = 2,     // payload: encoded task
+    JOURNAL_DELETE = 3,     // payload: u32 id
+    JOURNAL_COMPLETE = 4,   // payload: u32 id, u32 completed
+    JOURNAL_DEPENDENCY = 5  // payload: u32 task id, u32 prerequisite id, u32 present
+} JournalRecordType;
+
+// Duplicate-detection entry: hash of a task's normalized description (id 0 = empty)
+typedef struct {
+    unsigned long long hash;
+    int id;
+} DuplicateEntry;
+
+// Finds needle in haystack ignoring ASCII case; returns the match or NULL
+typedef const char* (*SubstringKernel)(const char *haystack, size_t haystackLength,
+                                       const char *needle, size_t needleLength);
+
+// Task IDs whose description contains one case-folded trigram
+typedef struct {
+    unsigned int key;   // TRIGRAM_EMPTY for an unused table entry
+    bool sorted;        // ids ascending with no repeats
+    int count;
+    int capacity;
+    int *ids;
+} TrigramPostings;
+
+// Interned description: where it lives in the arena and how many slots use it
+typedef struct {
+    unsigned int offset;
+    unsigned int hash;
+    int refs;           // 0 for an unused table entry
+} InternEntry;
+
+// Line formats for importing and exporting tasks
+typedef enum {
+    FORMAT_TEXT = 0,    // "PRIORITY DURATION DESCRIPTION"
+    FORMAT_CSV = 1,     // RFC 4180, with a header row naming the fields
+    FORMAT_JSONL = 2,   // one flat JSON object per line
+    RECORD_FORMAT_COUNT = 3
+} RecordFormat;
+
+// Task fields as named in CSV headers and JSON keys
+typedef enum {
+    FIELD_ID = 0,
+    FIELD_DESCRIPTION = 1,
+    FIELD_PRIORITY = 2,
+    FIELD_DURATION = 3,
+    FIELD_CREATED = 4,
+    FIELD_COMPLETED = 5,
+    FIELD_IGNORED = 6
+} RecordField;
+
+// Buffered byte stream that import parsers read a record at a time from,
+// so a file of any size is read in constant memory
 typedef struct {
-    Task *task;
-    int *isRunning;
-    int taskIndex;
-} ThreadArgs;
+    FILE *file;
+    unsigned char *buffer;      // STREAM_BUFFER_SIZE bytes
+    size_t length;
+    size_t position;
+    long long line;             // line being read
+    long long recordLine;       // line the current record started on
+    RecordField columns[CSV_MAX_COLUMNS];   // CSV column -> field, from the header
+    int columnCount;
+    bool headerRead;
+} RecordReader;
 
-Task tasks[MAX_TASKS];
-int taskCount = 0;
+// Growable task store, kept as a structure of arrays: slot i of every column
+// belongs to the same task. The small fields that filters, counts and sorts
+// read sit in dense hot columns; descriptions are referenced by arena offset.
+// Slots [0, taskSlotCount) are in use and taskCapacity slots are allocated.
+// Deleted tasks leave a tombstone (id 0) whose slot goes on the free list for reuse.
+int *taskIds = NULL;
+Priority *taskPriorities = NULL;
+int *taskDurations = NULL;
+time_t *taskCreated = NULL;
+bool *taskCompleted = NULL;
+unsigned int *taskDescriptionOffsets = NULL;
+int taskCount = 0;       // live tasks
+int taskSlotCount = 0;   // live tasks + tombstones
+int taskCapacity = 0;
+int *freeSlots = NULL;
+int freeSlotCount = 0;
+int freeSlotCapacity = 0;
 int nextTaskId = 1;
 
+// Description text, NUL-terminated strings packed back to back. Equal
+// descriptions are interned into one copy shared by reference count. Offset 0
+// holds the empty string, which is never counted. Strings nobody references
+// any more are reclaimed in bulk by compacting the arena.
+char *descriptionArena = NULL;
+size_t descriptionArenaUsed = 0;
+size_t descriptionArenaCapacity = 0;
+size_t descriptionArenaStale = 0;   // bytes of strings no slot references
+
+// Dependency edges, sorted by (task, prerequisite) and keyed by ID so they
+// survive slots moving. IDs are never reused, so an edge to a deleted task
+// is simply ignored (the constraint went with it) and dropped at the next
+// snapshot rather than searched for on every delete.
+DependencyEdge *dependencies = NULL;
+int dependencyCount = 0;
+int dependencyCapacity = 0;
+bool dependenciesSorted = true;   // false while replayed edges sit unsorted at the end
+
+// Scratch for dependsOn(), kept between calls: a slot counts as visited when
+// its stamp equals the current generation, so no clearing per walk
+unsigned int *dependencyVisits = NULL;
+int *dependencyStack = NULL;
+int dependencyScratchCapacity = 0;
+unsigned int dependencyVisitGeneration = 0;
+
+// Open-addressing table of interned descriptions, keyed by string hash
+InternEntry *internTable = NULL;
+int internTableCapacity = 0;
+int internTableCount = 0;
+
+// Indexes are built on first use after a load, so startup does not have to
+// touch every task. The search and duplicate indexes wait for their own first
+// use; while stale they ignore updates since they will be rebuilt anyway.
+bool indexesStale = false;
+bool trigramIndexStale = false;
+bool duplicateIndexStale = false;
+
+// Threads that decode a snapshot and rebuild the indexes; 0 = one per core
+int loadThreadCount = 0;
+
+// Open-addressing hash index from task ID to store slot (key 0 = empty)
+int *idIndexKeys = NULL;
+int *idIndexSlots = NULL;
+int idIndexCapacity = 0;
+int idIndexCount = 0;
+
+// Secondary indexes: a bucket per priority, the pending set and created-time order
+SlotSet priorityBuckets[3];
+SlotSet pendingSet;
+int *bucketPos = NULL;     // position of each slot inside its priority bucket
+int *pendingPos = NULL;    // position of each slot inside pendingSet, -1 if not pending
+CreatedEntry *createdIndex = NULL;
+int createdIndexCount = 0;
+int createdIndexCapacity = 0;
+int createdIndexStale = 0;   // entries whose task has been deleted
+bool createdIndexSorted = true;   // false once an old task was appended out of order
+
+// Inverted index from description trigrams to task IDs (open addressing on key)
+TrigramPostings *trigramTable = NULL;
+int trigramTableCapacity = 0;
+int trigramTableCount = 0;
+long long trigramPostingCount = 0;
+long long trigramStalePostings = 0;   // postings left behind by deletes and edits
+
+// Append-only journal of changes since the last snapshot of tasks.dat
+FILE *journalFile = NULL;
+int journalRecords = 0;
+
+// Hash multiset of normalized descriptions, for O(1) duplicate checks on add
+DuplicateEntry *duplicateTable = NULL;
+int duplicateTableCapacity = 0;
+int duplicateTableCount = 0;
+
+// CRC32C implementation in use (SSE4.2 when available) and the table for the
+// portable one; both are set up exactly once, whichever thread hashes first
+unsigned int (*crc32cKernel)(unsigned int crc, const void *data, size_t length) = NULL;
+const char *crc32cKernelName = "none";
+unsigned int crc32cTable[256];
+pthread_once_t crc32cOnce = PTHREAD_ONCE_INIT;
+
+// Substring kernel in use, picked on first search from what the CPU supports
+SubstringKernel substringKernel = NULL;
+const char *substringKernelName = "scalar";
+
+// Cancellation of the run in progress, from Ctrl+C while one is armed
+CancelToken executionCancel = {false};
+
+// Where an interactive timer-wheel run publishes its completions
+CompletionLog *timerCompletions = NULL;
+
+// Executor worker pool, started on first use and kept for later runs
+ExecutorPool executor = {.stealing = true, .runJob = NULL, .lock = PTHREAD_MUTEX_INITIALIZER,
+                         .workReady = PTHREAD_COND_INITIALIZER, .batchDone = PTHREAD_COND_INITIALIZER,
+                         .jobsReleased = PTHREAD_COND_INITIALIZER};
+
+// Policy offered first for parallel runs; the last one picked is remembered
+SchedulePolicy schedulePolicy = POLICY_PRIORITY;
+
+const char *recordFormatNames[RECORD_FORMAT_COUNT] = {"text", "csv", "jsonl"};
+const char *recordFieldNames[FIELD_IGNORED] = {"id", "description", "priority", "duration", "created", "completed"};
+
 // Function prototypes
 void clearInputBuffer();
+char* readLine(FILE *stream);
+bool reserveTasks(int needed);
+void shrinkTasks();
+bool resizeColumn(void **column, size_t bytes);
+bool resizeTaskColumns(int capacity);
+void freeTaskColumns();
+Task taskAt(int slot);
+void storeTaskAt(int slot, const Task *t);
+void moveTaskSlot(int to, int from);
+void setTaskDescription(int slot, const char *description);
+const char* taskDescription(int slot);
+unsigned int hashDescription(const char *text, size_t length);
+bool reserveDescriptionArena(size_t needed);
+bool reserveInternTable(int needed);
+void internTableInsert(unsigned int hash, unsigned int offset, int refs);
+unsigned int internDescription(const char *text);
+unsigned int internDescriptionText(const char *text, size_t length, unsigned int hash);
+void releaseDescription(unsigned int offset);
+void compactDescriptionArena();
+void compactDescriptionsIfNeeded();
+void freeDescriptionArena();
+void resetTaskStore();
+int dependencyLowerBound(int task, int prerequisite);
+bool hasDependency(int task, int prerequisite);
+bool reserveDependencies(int needed);
+bool reserveDependencyScratch(int needed);
+bool dependsOn(int task, int target);
+bool addDependency(int task, int prerequisite);
+bool appendDependency(int task, int prerequisite);
+bool removeDependency(int task, int prerequisite);
+int formatPrerequisites(int task, bool pendingOnly, char *out, size_t size);
+void freeDependencies();
+int compareDependencyEdges(const void *a, const void *b);
+void sortDependencies();
+void ensureDependenciesSorted();
+void* mapFile(const char *path, size_t *size);
+void unmapFile(void *base, size_t size);
+unsigned char* readFile(const char *path, size_t *size);
+void putUint32(unsigned char *p, unsigned int value);
+unsigned int getUint32(const unsigned char *p);
+size_t putVarint(unsigned char *p, unsigned long long value);
+bool getVarint(const unsigned char **p, const unsigned char *end, unsigned long long *value);
+size_t encodeTaskRecord(unsigned char *out, int slot, long long *previousCreated);
+bool decodeTaskFields(const unsigned char **p, const unsigned char *end, Task *t, long long *previousCreated, size_t *length);
+bool decodeTaskRecord(const unsigned char **p, const unsigned char *end, Task *t, long long *previousCreated);
+int parallelLoadThreads(int tasks);
+void runOnThreads(void *(*body)(void*), void *args, size_t argSize, int threads);
+bool decodeSnapshotBlock(SnapshotBlock *block, DescriptionRef *descriptions);
+void* decodeBlocksThread(void *arg);
+bool decodeBlocksInParallel(const unsigned char **p, const unsigned char *end, unsigned int storedCount, int threads, bool *damaged);
+void decodeLegacySnapshot(const char *path, const unsigned char *data, size_t size);
+void decodeSnapshot(const char *path, const unsigned char *data, size_t size);
+void decodeDependencySection(const char *path, const unsigned char *p, const unsigned char *end);
+int loadSnapshot(const char *path, bool useMapping);
+void ensureIndexes();
+bool appendTask(const Task *t);
+void removeTaskAt(int slot);
+void compactTasks();
+void formatBytes(size_t bytes, char *buffer, size_t size);
+unsigned int hashTaskId(int id);
+bool reserveIdIndex(int needed);
+void idIndexPut(int id, int slot);
+void idIndexRemove(int id);
+IndexRange* splitSlotRanges(int threads);
+void* idIndexThread(void *arg);
+void rebuildIdIndex();
+int findTaskIndex(int id);
+bool resizeSlotPositions(int capacity);
+int priorityBucket(Priority p);
+bool slotSetAdd(SlotSet *set, int *positions, int slot);
+void slotSetRemove(SlotSet *set, int *positions, int slot);
+void indexTaskSlot(int slot);
+void unindexTaskSlot(int slot);
+bool addCreatedEntry(const Task *t);
+int compareCreatedEntries(const void *a, const void *b);
+void purgeCreatedIndex();
+bool reserveSlotSet(SlotSet *set, int needed);
+void* countIndexThread(void *arg);
+void* fillIndexThread(void *arg);
+void mergeCreatedRuns(const CreatedEntry *left, int leftCount, const CreatedEntry *right, int rightCount, CreatedEntry *out);
+void* mergeCreatedThread(void *arg);
+bool mergeCreatedIndex(const int *bounds, int runs);
+bool rebuildSecondaryIndexesInParallel(int threads);
+void rebuildSecondaryIndexes();
+void setTaskCompleted(int slot, bool completed);
+void setTaskPriority(int slot, Priority priority);
+int compareInts(const void *a, const void *b);
+int* copySlotSet(const SlotSet *set, int *count);
+int* pendingTaskSlots(int *count);
+int* priorityTaskSlots(Priority priority, int *count);
+int* createdTaskOrder(int *count);
+unsigned int trigramKey(const char *text);
+int collectTrigrams(const char *text, unsigned int **keys);
+TrigramPostings* findTrigram(unsigned int key);
+TrigramPostings* trigramFor(unsigned int key);
+bool postingAppend(TrigramPostings *postings, int id);
+void preparePostings(TrigramPostings *postings);
+void trigramIndexAdd(int id, const char *description);
+void trigramIndexRemove(const char *description);
+void trigramIndexReplace(int id, const char *oldDescription, const char *newDescription);
+void clearTrigramIndex();
+void rebuildTrigramIndex();
+int intersectIds(const int *a, int aCount, const int *b, int bCount, int *out);
+int* termCandidates(const char *term, int *count);
+int foldCase(int c);
+bool equalsIgnoreCase(const char *a, const char *b, size_t length);
+const char* findIgnoreCaseScalar(const char *haystack, size_t haystackLength, const char *needle, size_t needleLength);
+#ifdef HAVE_X86_SIMD
+const char* findIgnoreCaseSse2(const char *haystack, size_t haystackLength, const char *needle, size_t needleLength);
+const char* findIgnoreCaseAvx2(const char *haystack, size_t haystackLength, const char *needle, size_t needleLength);
+#endif
+void selectSubstringKernel();
+bool containsIgnoreCase(const char *haystack, const char *needle);
+int splitSearchTerms(char *query, char ***terms);
+int* searchDescriptions(const char *query, int *count);
+double monotonicSeconds();
+unsigned int benchmarkRandom();
+void generateSyntheticTasks(int count);
+void runLookupBenchmark(int count);
+void runSortBenchmark(int count);
+void runSearchBenchmark(int count);
+void runSubstringBenchmark(int count);
+void runStartupBenchmark(int count);
+int compareRecordSlots(const void *a, const void *b);
+int compareColumnSlots(const void *a, const void *b);
+void runScanBenchmark(int count);
+double descriptionBytesPerTask();
+void runStringBenchmark(int count);
+void sleepMicroseconds(long long micros);
+int compareDoubles(const void *a, const void *b);
+bool benchmarkRunJob(int worker, const ExecutionJob *job);
+void* waveJobThread(void *arg);
+void runWaveSchedule(ExecutionJob *jobs, int count, int width);
+void reportSchedule(const char *name, int count, double wallTime, long long steals, long long predicted);
+void runExecutorBenchmark(int count);
+void fillSkewedJobs(ExecutionJob *jobs, int count);
+void runPlanBenchmark(int count);
+int fillRandomDependencies(int count, int *from, int *to);
+long long runLevelBarriers(int count, const int *level, int levels, ExecutionJob *levelJobs);
+void runDagBenchmark(int count);
+void recordTimerFinish(const ExecutionJob *jobs, int job, long long tick, bool finished);
+void runTimerBenchmark(int count);
+void runSimulateBenchmark(int count);
+bool stressRunJob(int worker, const ExecutionJob *job);
+const char* checkCompletions(int count, CompletionLog *log, const JobGraph *graph, int *position);
+void runCompletionBenchmark(int count);
+bool syncedRunJob(int worker, const ExecutionJob *job);
+void runCommitBenchmark(int count);
+void runImportBenchmark(int count);
+void runFormatBenchmark(int count);
+int runBenchmark(int argc, char *argv[]);
+void showStorageReport();
+bool writeSnapshot(const char *path);
 void saveTasksToFile();
 void loadTasksFromFile();
+void selectCrc32cKernel();
+unsigned int crc32cSoftware(unsigned int crc, const void *data, size_t length);
+#ifdef HAVE_X86_SIMD
+unsigned int crc32cSse42(unsigned int crc, const void *data, size_t length);
+#endif
+unsigned int crc32c(unsigned int crc, const void *data, size_t length);
+bool syncFile(FILE *file);
+bool syncParentDirectory(const char *path);
+bool replaceFile(const char *from, const char *to);
+bool journalAppend(JournalRecordType type, const void *payload, unsigned int length);
+bool journalSync();
+void journalTask(JournalRecordType type, int slot);
+bool journalTaskRecord(JournalRecordType type, int slot);
+void flushJournalBatch();
+void journalDelete(int id);
+void journalCompletion(int slot);
+bool journalCompletionRecord(int id, bool completed);
+void journalDependency(int task, int prerequisite, bool present);
+void checkpointIfNeeded();
+void replaceTaskAt(int slot, const Task *t);
+void applyJournalRecord(JournalRecordType type, const void *payload, unsigned int length);
+int replayJournal();
+int claimTaskId();
 void addTask();
 void viewTasks();
 void searchTasks();
 void deleteTask();
 void modifyTask();
+int processorCount();
+int compareTaskSlots(int a, int b, SortKey key);
+void mergeSlotRuns(const int *left, int leftCount, const int *right, int rightCount, int *out, SortKey key);
+void mergeSortSlots(int *slots, int *scratch, int count, SortKey key);
+void* sortRangeThread(void *arg);
+void* mergeRangeThread(void *arg);
+void sortTaskSlots(int *slots, int count, SortKey key, int threads);
+int* sortedTaskOrder(SortKey key, int *count);
+bool applyTaskOrder(const int *order, int count);
 void sortTasks();
 void executeTasks();
 void executeSpecificTask();
@@ -64,7 +741,130 @@ void showMenu();
 void displayTaskDetails(Task task);
 const char* priorityToString(Priority p);
 bool isDuplicateTask(const char* description, Priority priority, int duration);
-void* executeTaskThread(void* arg);
+int nextNormalizedChar(const char **cursor, bool *started);
+unsigned long long duplicateKey(const char *description, Priority priority, int duration);
+bool sameDuplicateKey(int slot, const char *description, Priority priority, int duration);
+bool reserveDuplicateIndex(int needed);
+void duplicateIndexInsert(unsigned long long hash, int id);
+void duplicateIndexAdd(int slot);
+void duplicateIndexRemove(int slot);
+void rebuildDuplicateIndex();
+int findDuplicateTask(const char *description, Priority priority, int duration);
+void requestCancel(CancelToken *token);
+bool cancelRequested(CancelToken *token);
+void cancelOnInterrupt(int signalNumber);
+void armCancellation();
+void disarmCancellation();
+bool completionLogInit(CompletionLog *log, int capacity);
+void completionLogFree(CompletionLog *log);
+void completionLogPublish(CompletionLog *log, int job);
+int completionLogRead(CompletionLog *log, int position);
+int commitPublished(GroupCommit *commit);
+void* groupCommitThread(void *arg);
+bool startGroupCommit(GroupCommit *commit, CompletionLog *log, const ExecutionJob *jobs);
+void stopGroupCommit(GroupCommit *commit);
+bool runExecutionJob(int worker, const ExecutionJob *job);
+WorkBuffer* allocWorkBuffer(long long capacity);
+bool dequeInit(WorkDeque *deque, long long capacity);
+void dequeReset(WorkDeque *deque);
+void dequeFree(WorkDeque *deque);
+bool dequePush(WorkDeque *deque, int item);
+int dequeTake(WorkDeque *deque);
+int dequeSteal(WorkDeque *deque);
+WorkDeque* workerDeque(int worker, int level);
+int stealExecutionJob(int worker, int level, unsigned int *seed);
+int nextExecutionJob(int worker, unsigned int *seed);
+void* executorWorker(void *arg);
+bool startExecutor(int workers);
+void stopExecutor();
+int jobLevel(const ExecutionJob *job);
+void releaseSuccessors(int worker, int job);
+void completeExecutionJob(int worker, int job);
+bool waitForReleasedJobs(int releasesSeen);
+void executeBatch(ExecutionJob *jobs, int count, const SchedulePlan *plan, const JobGraph *graph,
+                  CompletionLog *completions);
+int readWorkerCount();
+const char* policyName(SchedulePolicy policy);
+int priorityWeight(Priority p);
+long long policySortKey(const Task *t, SchedulePolicy policy);
+int comparePlanKeys(const void *a, const void *b);
+bool timedEntryBefore(const TimedEntry *a, const TimedEntry *b);
+void siftDownTimed(TimedEntry *heap, int count, int i);
+void siftUpTimed(TimedEntry *heap, int i);
+bool buildJobGraphFromEdges(JobGraph *graph, const ExecutionJob *jobs, int count,
+                            const int *from, const int *to, int edgeCount);
+bool buildJobGraph(JobGraph *graph, const ExecutionJob *jobs, int count);
+void freeJobGraph(JobGraph *graph);
+bool buildSchedulePlan(SchedulePlan *plan, const ExecutionJob *jobs, int count, int workers,
+                       SchedulePolicy policy, const JobGraph *graph);
+void freeSchedulePlan(SchedulePlan *plan);
+void printCriticalPath(const JobGraph *graph, const ExecutionJob *jobs);
+void printSchedulePlan(const SchedulePlan *plan, const ExecutionJob *jobs, const JobGraph *graph);
+void comparePolicies(const ExecutionJob *jobs, int count, int workers, const JobGraph *graph);
+SchedulePolicy readSchedulePolicy();
+ExecutionJob* selectExecutionJobs(int *count);
+ExecutionJob* jobsForSelection(bool *selectedTasks, int numSelected, int *count);
+void runJobsOnPool(ExecutionJob *jobs, int jobCount, const JobGraph *graph, int workers, SchedulePolicy policy, bool confirm);
+void planParallelRun();
+bool timerWheelInit(TimerWheel *wheel, int jobs);
+void timerWheelFree(TimerWheel *wheel);
+void timerWheelAdd(TimerWheel *wheel, int job, long long expires);
+void timerWheelCascade(TimerWheel *wheel, int level);
+int timerWheelAdvance(TimerWheel *wheel);
+long long runTimerEngine(const ExecutionJob *jobs, int count, int slots, SchedulePolicy policy,
+                         const JobGraph *graph, long long tickMicros, TimerEvent onEvent);
+void printTimerEvent(const ExecutionJob *jobs, int job, long long tick, bool finished);
+int readTimerSlots(int count);
+void executeOnTimerWheel();
+int* completionOrder(const SchedulePlan *plan, const ExecutionJob *jobs);
+void printSimulation(const SchedulePlan *plan, const ExecutionJob *jobs, const int *completed, double elapsed);
+bool writeSimulationTimeline(const char *path, const SchedulePlan *plan, const ExecutionJob *jobs,
+                             const int *completed);
+void sweepWorkerCounts(const ExecutionJob *jobs, int count, SchedulePolicy policy, const JobGraph *graph);
+void simulateRun();
+bool sameWordIgnoreCase(const char *text, const char *word);
+bool parsePriorityName(const char *text, Priority *priority);
+bool parsePolicyName(const char *text, SchedulePolicy *policy);
+const char* parseTaskRecord(char *line, Task *t);
+bool addTaskRecord(Task *t, bool keepDuplicates, bool *added);
+bool parseRecordFormat(const char *name, RecordFormat *format);
+RecordFormat formatForPath(const char *path, RecordFormat fallback);
+bool readerInit(RecordReader *reader, FILE *file);
+void readerFree(RecordReader *reader);
+int readerPeek(RecordReader *reader);
+int readerNext(RecordReader *reader);
+void readerCopyUntil(RecordReader *reader, int stopA, int stopB, char *value, size_t size, size_t *length);
+void readerSkipLine(RecordReader *reader);
+RecordField recordFieldByName(const char *name);
+const char* setRecordField(Task *t, RecordField field, const char *value, unsigned int *seen);
+const char* checkRecordFields(const Task *t, unsigned int seen);
+int readCsvField(RecordReader *reader, char *value, size_t size);
+bool readCsvHeader(RecordReader *reader);
+int nextCsvRecord(RecordReader *reader, Task *t, const char **error);
+void skipJsonSpace(RecordReader *reader);
+void putUtf8(char *value, size_t size, size_t *length, unsigned int code);
+bool readJsonHex(RecordReader *reader, unsigned int *code);
+bool readJsonString(RecordReader *reader, char *value, size_t size);
+bool readJsonLiteral(RecordReader *reader, char *value, size_t size);
+const char* parseJsonObject(RecordReader *reader, Task *t);
+int nextJsonRecord(RecordReader *reader, Task *t, const char **error);
+int nextTextRecord(RecordReader *reader, Task *t, const char **error);
+int nextRecord(RecordReader *reader, RecordFormat format, Task *t, const char **error);
+size_t formatDecimal(char *out, long long value);
+size_t formatCsvText(char *out, const char *text);
+size_t formatJsonText(char *out, const char *text);
+size_t formatTaskRow(char *out, int slot, RecordFormat format);
+long long exportTasks(FILE *out, RecordFormat format);
+bool importTasks(FILE *in, const char *name, RecordFormat format, bool keepDuplicates);
+int commandAdd(int argc, char *argv[]);
+int commandImport(int argc, char *argv[]);
+int commandExport(int argc, char *argv[]);
+int commandQuery(int argc, char *argv[]);
+int commandRun(int argc, char *argv[]);
+int commandBatch(int argc, char *argv[]);
+bool isCommand(const char *name);
+int dispatchCommand(int argc, char *argv[]);
+int runCommandLine(int argc, char *argv[]);
 
 // Helper function to clear input buffer
 void clearInputBuffer() {
@@ -72,838 +872,8751 @@ void clearInputBuffer() {
     while ((c = getchar()) != '\n' && c != EOF);
 }
 
-// Save tasks to file
-void saveTasksToFile() {
-    FILE *file = fopen(FILENAME, "wb");
+// Read a whole line of any length; the caller frees the result (NULL on EOF)
+char* readLine(FILE *stream) {
+    size_t capacity = 64;
+    size_t length = 0;
+    char *line = (char*)malloc(capacity);
+    if (line == NULL) {
+        return NULL;
+    }
     
-    if (file == NULL) {
-        printf("Error: Cannot open file for writing.\n");
-        return;
+    int c;
+    while ((c = fgetc(stream)) != EOF && c != '\n') {
+        if (length + 1 >= capacity) {
+            char *grown = (char*)realloc(line, capacity * 2);
+            if (grown == NULL) {
+                free(line);
+                return NULL;
+            }
+            line = grown;
+            capacity *= 2;
+        }
+        line[length++] = (char)c;
     }
     
-    // Write the next task ID first
-    fwrite(&nextTaskId, sizeof(int), 1, file);
+    if (c == EOF && length == 0) {
+        free(line);
+        return NULL;
+    }
+    line[length] = '\0';
+    return line;
+}
+
+// Make room for at least `needed` tasks. Capacity grows by 1.5x so appends are
+// amortized O(1) while never reserving more than half again what is in use.
+bool reserveTasks(int needed) {
+    if (needed <= taskCapacity) {
+        return true;
+    }
     
-    // Write the number of tasks
-    fwrite(&taskCount, sizeof(int), 1, file);
+    size_t newCapacity = taskCapacity < INITIAL_TASK_CAPACITY ? INITIAL_TASK_CAPACITY : (size_t)taskCapacity;
+    while (newCapacity < (size_t)needed) {
+        newCapacity += newCapacity / 2;
+    }
+    if (newCapacity > INT_MAX) {
+        newCapacity = INT_MAX;
+    }
     
-    // Write each task
-    fwrite(tasks, sizeof(Task), taskCount, file);
+    if (!resizeTaskColumns((int)newCapacity) || !resizeSlotPositions((int)newCapacity)) {
+        printf("Error: Out of memory growing task store to %zu tasks.\n", newCapacity);
+        return false;
+    }
     
-    fclose(file);
-    printf("Tasks saved to %s\n", FILENAME);
+    taskCapacity = (int)newCapacity;
+    return true;
 }
 
-// Load tasks from file
-void loadTasksFromFile() {
-    FILE *file = fopen(FILENAME, "rb");
-    
-    if (file == NULL) {
-        printf("No saved tasks found. Starting with empty task list.\n");
+// Give memory back once the store is less than a quarter full
+void shrinkTasks() {
+    if (taskCapacity <= INITIAL_TASK_CAPACITY || taskSlotCount >= taskCapacity / 4) {
         return;
     }
     
-    // Read the next task ID
-    fread(&nextTaskId, sizeof(int), 1, file);
-    
-    // Read the number of tasks
-    fread(&taskCount, sizeof(int), 1, file);
-    
-    if (taskCount > MAX_TASKS) {
-        printf("Warning: File contains more tasks than maximum allowed. Loading only %d tasks.\n", MAX_TASKS);
-        taskCount = MAX_TASKS;
+    int newCapacity = taskCapacity;
+    while (newCapacity / 2 >= INITIAL_TASK_CAPACITY && taskSlotCount < newCapacity / 4) {
+        newCapacity /= 2;
     }
     
-    // Read each task
-    fread(tasks, sizeof(Task), taskCount, file);
-    
-    fclose(file);
-    printf("Loaded %d tasks from %s\n", taskCount, FILENAME);
+    // A column that cannot shrink keeps its larger block, which is still valid
+    resizeTaskColumns(newCapacity);
+    taskCapacity = newCapacity;
+    resizeSlotPositions(newCapacity);
 }
 
-// Convert priority enum to string
-const char* priorityToString(Priority p) {
-    switch (p) {
-        case HIGH: return "High";
-        case MEDIUM: return "Medium";
-        case LOW: return "Low";
-        default: return "Unknown";
+// Resize one column, leaving it untouched if realloc fails
+bool resizeColumn(void **column, size_t bytes) {
+    void *resized = realloc(*column, bytes);
+    if (resized == NULL) {
+        return false;
     }
+    *column = resized;
+    return true;
 }
 
-// Function to check if a task with similar description and properties already exists
-bool isDuplicateTask(const char* description, Priority priority, int duration) {
-    for (int i = 0; i < taskCount; i++) {
-        // Check for exact description match
-        if (strcmp(tasks[i].description, description) == 0) {
-            printf("\n⚠️ Similar task already exists! ⚠️\n");
-            displayTaskDetails(tasks[i]);
-            printf("Do you still want to add this task? (1=Yes, 0=No): ");
-            int confirm;
-            scanf("%d", &confirm);
-            return confirm != 1;
-        }
-    }
-    return false;
+// Resize every column to `capacity` slots
+bool resizeTaskColumns(int capacity) {
+    size_t n = capacity > 0 ? (size_t)capacity : 1;
+    bool resized = resizeColumn((void**)&taskIds, n * sizeof(int));
+    resized = resizeColumn((void**)&taskPriorities, n * sizeof(Priority)) && resized;
+    resized = resizeColumn((void**)&taskDurations, n * sizeof(int)) && resized;
+    resized = resizeColumn((void**)&taskCreated, n * sizeof(time_t)) && resized;
+    resized = resizeColumn((void**)&taskCompleted, n * sizeof(bool)) && resized;
+    resized = resizeColumn((void**)&taskDescriptionOffsets, n * sizeof(unsigned int)) && resized;
+    return resized;
 }
 
-// Function to display a single task with details
-void displayTaskDetails(Task task) {
-    char timeStr[30];
-    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&task.created));
-    
-    printf("┌──────────────────────────────────────────────────────────────┐\n");
-    printf("│ Task ID: %-52d │\n", task.id);
-    printf("├──────────────────────────────────────────────────────────────┤\n");
-    printf("│ Description: %-48s │\n", task.description);
-    printf("│ Priority:    %-48s │\n", priorityToString(task.priority));
-    printf("│ Duration:    %-2d seconds                                      │\n", task.duration);
-    printf("│ Created:     %-48s │\n", timeStr);
-    printf("│ Status:      %-48s │\n", task.completed ? "Completed" : "Pending");
-    printf("└──────────────────────────────────────────────────────────────┘\n");
+void freeTaskColumns() {
+    free(taskIds);
+    free(taskPriorities);
+    free(taskDurations);
+    free(taskCreated);
+    free(taskCompleted);
+    free(taskDescriptionOffsets);
+    taskIds = NULL;
+    taskPriorities = NULL;
+    taskDurations = NULL;
+    taskCreated = NULL;
+    taskCompleted = NULL;
+    taskDescriptionOffsets = NULL;
 }
 
-// Function to add a new task
-void addTask() {
-    if (taskCount >= MAX_TASKS) {
-        printf("Task limit reached.\n");
-        return;
-    }
-
+// Gather a task out of the columns
+Task taskAt(int slot) {
     Task t;
-    t.id = nextTaskId++;
-    t.created = time(NULL);
-    t.completed = false;
+    t.id = taskIds[slot];
+    t.priority = taskPriorities[slot];
+    t.duration = taskDurations[slot];
+    t.created = taskCreated[slot];
+    t.completed = taskCompleted[slot];
+    strcpy(t.description, taskDescription(slot));
+    return t;
+}
 
-    printf("\n=== Adding New Task ===\n");
-    printf("Task ID: %d (auto-assigned)\n", t.id);
-    
-    clearInputBuffer();
-    printf("Enter description: ");
-    fgets(t.description, MAX_DESCRIPTION, stdin);
-    t.description[strcspn(t.description, "\n")] = 0;
+// Scatter a task into the columns (indexes are the caller's job). The slot
+// must not hold a description reference; replacing one releases it first.
+void storeTaskAt(int slot, const Task *t) {
+    taskIds[slot] = t->id;
+    taskPriorities[slot] = t->priority;
+    taskDurations[slot] = t->duration;
+    taskCreated[slot] = t->created;
+    taskCompleted[slot] = t->completed;
+    taskDescriptionOffsets[slot] = internDescription(t->description);
+}
+
+void moveTaskSlot(int to, int from) {
+    taskIds[to] = taskIds[from];
+    taskPriorities[to] = taskPriorities[from];
+    taskDurations[to] = taskDurations[from];
+    taskCreated[to] = taskCreated[from];
+    taskCompleted[to] = taskCompleted[from];
+    taskDescriptionOffsets[to] = taskDescriptionOffsets[from];
+}
+
+// Change a task's description, keeping the search index in step
+void setTaskDescription(int slot, const char *description) {
+    trigramIndexReplace(taskIds[slot], taskDescription(slot), description);
+    releaseDescription(taskDescriptionOffsets[slot]);
+    taskDescriptionOffsets[slot] = internDescription(description);
+    compactDescriptionsIfNeeded();
+}
+
+// A task's description. The pointer is only good until the next description
+// is stored, since the arena may move when it grows or is compacted.
+const char* taskDescription(int slot) {
+    return descriptionArena + taskDescriptionOffsets[slot];
+}
+
+// 32-bit FNV-1a
+unsigned int hashDescription(const char *text, size_t length) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Make room for `needed` arena bytes, growing by 1.5x. The first call also
+// lays down the shared empty string at offset 0.
+bool reserveDescriptionArena(size_t needed) {
+    if (descriptionArena != NULL && needed <= descriptionArenaCapacity) {
+        return true;
+    }
     
-    int priorityChoice;
-    do {
-        printf("Select priority:\n");
-        printf("1. High\n");
-        printf("2. Medium\n");
-        printf("3. Low\n");
-        printf("Choice: ");
-        scanf("%d", &priorityChoice);
-        
-        switch (priorityChoice) {
-            case 1: t.priority = HIGH; break;
-            case 2: t.priority = MEDIUM; break;
-            case 3: t.priority = LOW; break;
-            default: printf("Invalid choice. Try again.\n");
+    size_t newCapacity = descriptionArenaCapacity < INITIAL_ARENA_CAPACITY ? INITIAL_ARENA_CAPACITY : descriptionArenaCapacity;
+    while (newCapacity < needed) {
+        newCapacity += newCapacity / 2;
+    }
+    // Offsets are 32 bits wide
+    if (newCapacity > UINT_MAX) {
+        newCapacity = UINT_MAX;
+        if (needed > newCapacity) {
+            return false;
         }
-    } while (priorityChoice < 1 || priorityChoice > 3);
+    }
+    
+    char *grown = (char*)realloc(descriptionArena, newCapacity);
+    if (grown == NULL) {
+        return false;
+    }
+    if (descriptionArena == NULL) {
+        grown[0] = '\0';
+        descriptionArenaUsed = 1;
+    }
+    descriptionArena = grown;
+    descriptionArenaCapacity = newCapacity;
+    return true;
+}
 
-    do {
-        printf("Enter duration (in seconds, 1-3600): ");
-        scanf("%d", &t.duration);
-        
-        if (t.duration < 1 || t.duration > 3600) {
-            printf("Invalid duration. Please enter a value between 1 and 3600 seconds.\n");
+// Keep the intern table at most half full
+bool reserveInternTable(int needed) {
+    if (needed * 2 <= internTableCapacity) {
+        return true;
+    }
+    
+    int newCapacity = internTableCapacity > 0 ? internTableCapacity : INITIAL_INDEX_CAPACITY;
+    while (newCapacity < needed * 2) {
+        if (newCapacity > INT_MAX / 2) {
+            return false;
         }
-    } while (t.duration < 1 || t.duration > 3600);
+        newCapacity *= 2;
+    }
+    
+    InternEntry *newTable = (InternEntry*)calloc(newCapacity, sizeof(InternEntry));
+    if (newTable == NULL) {
+        return false;
+    }
+    
+    InternEntry *oldTable = internTable;
+    int oldCapacity = internTableCapacity;
+    internTable = newTable;
+    internTableCapacity = newCapacity;
+    internTableCount = 0;
+    
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldTable[i].refs != 0) {
+            internTableInsert(oldTable[i].hash, oldTable[i].offset, oldTable[i].refs);
+        }
+    }
+    free(oldTable);
+    return true;
+}
 
-    // Check for duplicate tasks
-    if (isDuplicateTask(t.description, t.priority, t.duration)) {
-        return;
+// Place an entry (capacity must already be reserved)
+void internTableInsert(unsigned int hash, unsigned int offset, int refs) {
+    unsigned int mask = (unsigned int)internTableCapacity - 1;
+    unsigned int i = hash & mask;
+    while (internTable[i].refs != 0) {
+        i = (i + 1) & mask;
     }
+    internTable[i].offset = offset;
+    internTable[i].hash = hash;
+    internTable[i].refs = refs;
+    internTableCount++;
+}
 
-    tasks[taskCount++] = t;
-    printf("\nTask added successfully!\n");
+// Arena offset of a description, sharing the existing copy when an equal
+// one is already stored. Text longer than a Task buffer is cut to fit, as
+// the fixed column did. `text` must not point into the arena. If memory runs
+// out the task gets the empty description.
+unsigned int internDescription(const char *text) {
+    size_t length = strnlen(text, MAX_DESCRIPTION - 1);
+    return internDescriptionText(text, length, hashDescription(text, length));
+}
+
+// Intern `length` bytes of text (not necessarily terminated) whose hash is
+// already known, as a parallel load computes them ahead of time
+unsigned int internDescriptionText(const char *text, size_t length, unsigned int hash) {
+    if (length == 0 && reserveDescriptionArena(1)) {
+        return 0;
+    }
+    
+    if (internTableCapacity > 0) {
+        unsigned int mask = (unsigned int)internTableCapacity - 1;
+        for (unsigned int i = hash & mask; internTable[i].refs != 0; i = (i + 1) & mask) {
+            const char *stored = descriptionArena + internTable[i].offset;
+            if (internTable[i].hash == hash && memcmp(stored, text, length) == 0 && stored[length] == '\0') {
+                internTable[i].refs++;
+                return internTable[i].offset;
+            }
+        }
+    }
     
-    saveTasksToFile();
+    if (!reserveInternTable(internTableCount + 1) ||
+        !reserveDescriptionArena(descriptionArenaUsed + length + 1)) {
+        printf("Error: Out of memory storing task description.\n");
+        return 0;
+    }
+    
+    unsigned int offset = (unsigned int)descriptionArenaUsed;
+    memcpy(descriptionArena + offset, text, length);
+    descriptionArena[offset + length] = '\0';
+    descriptionArenaUsed += length + 1;
+    internTableInsert(hash, offset, 1);
+    return offset;
 }
 
-// Function to display all tasks
-void viewTasks() {
-    if (taskCount == 0) {
-        printf("\nNo tasks available.\n");
+// Drop one reference. A string nobody uses leaves the table and its bytes
+// count as stale until the next compaction.
+void releaseDescription(unsigned int offset) {
+    if (offset == 0 || internTableCapacity == 0) {
         return;
     }
-
-    printf("\n=== Task List (%d tasks) ===\n", taskCount);
-    printf("┌─────┬───────────────────────────────┬──────────┬──────────┬──────────┐\n");
-    printf("│ ID  │ Description                   │ Priority │ Duration │ Status   │\n");
-    printf("├─────┼───────────────────────────────┼──────────┼──────────┼──────────┤\n");
     
-    for (int i = 0; i < taskCount; i++) {
-        // Truncate description if too long for display
-        char shortDesc[30];
-        strncpy(shortDesc, tasks[i].description, 25);
-        shortDesc[25] = '\0';
-        if (strlen(tasks[i].description) > 25) {
-            strcat(shortDesc, "...");
+    size_t length = strlen(descriptionArena + offset);
+    unsigned int hash = hashDescription(descriptionArena + offset, length);
+    unsigned int mask = (unsigned int)internTableCapacity - 1;
+    unsigned int i = hash & mask;
+    while (internTable[i].offset != offset || internTable[i].refs == 0) {
+        if (internTable[i].refs == 0) {
+            return;
         }
-        
-        printf("│ %-3d │ %-27s │ %-8s │ %-8d │ %-8s │\n", 
-               tasks[i].id, 
-               shortDesc, 
-               priorityToString(tasks[i].priority), 
-               tasks[i].duration,
-               tasks[i].completed ? "Done" : "Pending");
+        i = (i + 1) & mask;
     }
-    printf("└─────┴───────────────────────────────┴──────────┴──────────┴──────────┘\n");
     
-    printf("\nEnter task ID for details or 0 to return: ");
-    int id;
-    scanf("%d", &id);
+    if (--internTable[i].refs > 0) {
+        return;
+    }
+    descriptionArenaStale += length + 1;
     
-    if (id != 0) {
-        for (int i = 0; i < taskCount; i++) {
-            if (tasks[i].id == id) {
-                displayTaskDetails(tasks[i]);
-                return;
-            }
+    // Shift later entries of the probe chain back into the gap
+    unsigned int gap = i;
+    for (unsigned int j = (gap + 1) & mask; internTable[j].refs != 0; j = (j + 1) & mask) {
+        unsigned int home = internTable[j].hash & mask;
+        if (((j - home) & mask) >= ((j - gap) & mask)) {
+            internTable[gap] = internTable[j];
+            gap = j;
         }
-        printf("Task not found.\n");
     }
+    internTable[gap].refs = 0;
+    internTableCount--;
 }
 
-// Search for tasks
-void searchTasks() {
-    if (taskCount == 0) {
-        printf("\nNo tasks available to search.\n");
+// Copy the strings live tasks still use into a fresh arena, freeing every
+// stale string in one go. Live slots are re-interned, so the copies stay shared.
+void compactDescriptionArena() {
+    if (descriptionArena == NULL || descriptionArenaStale == 0) {
         return;
     }
     
-    printf("\n=== Search Tasks ===\n");
-    printf("1. Search by keyword\n");
-    printf("2. Search by priority\n");
-    printf("3. Return to main menu\n");
-    printf("Choice: ");
-    
+    size_t liveBytes = descriptionArenaUsed - descriptionArenaStale;
+    size_t capacity = liveBytes + liveBytes / 2;
+    char *newArena = (char*)malloc(capacity > INITIAL_ARENA_CAPACITY ? capacity : INITIAL_ARENA_CAPACITY);
+    if (newArena == NULL) {
+        // Keep the old arena; its stale bytes wait for the next attempt
+        return;
+    }
+    
+    // Size the table for the strings that survive; keep the old one if that fails
+    int tableCapacity = INITIAL_INDEX_CAPACITY;
+    while (tableCapacity < internTableCount * 2) {
+        tableCapacity *= 2;
+    }
+    if (tableCapacity < internTableCapacity) {
+        InternEntry *smaller = (InternEntry*)malloc((size_t)tableCapacity * sizeof(InternEntry));
+        if (smaller != NULL) {
+            free(internTable);
+            internTable = smaller;
+            internTableCapacity = tableCapacity;
+        }
+    }
+    
+    char *oldArena = descriptionArena;
+    descriptionArena = newArena;
+    descriptionArenaCapacity = capacity > INITIAL_ARENA_CAPACITY ? capacity : INITIAL_ARENA_CAPACITY;
+    descriptionArena[0] = '\0';
+    descriptionArenaUsed = 1;
+    descriptionArenaStale = 0;
+    memset(internTable, 0, (size_t)internTableCapacity * sizeof(InternEntry));
+    internTableCount = 0;
+    
+    // Everything fits: the table has room for every survivor and the arena holds the live bytes
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] != 0) {
+            taskDescriptionOffsets[i] = internDescription(oldArena + taskDescriptionOffsets[i]);
+        }
+    }
+    free(oldArena);
+}
+
+// Compact once stale strings fill half the arena; the copy is paid for by
+// the deletes and edits that made them stale
+void compactDescriptionsIfNeeded() {
+    if (descriptionArenaStale >= ARENA_COMPACT_MIN_STALE && descriptionArenaStale * 2 >= descriptionArenaUsed) {
+        compactDescriptionArena();
+    }
+}
+
+void freeDescriptionArena() {
+    free(descriptionArena);
+    descriptionArena = NULL;
+    descriptionArenaUsed = 0;
+    descriptionArenaCapacity = 0;
+    descriptionArenaStale = 0;
+    free(internTable);
+    internTable = NULL;
+    internTableCapacity = 0;
+    internTableCount = 0;
+}
+
+// Index of the first edge at or after (task, prerequisite)
+int dependencyLowerBound(int task, int prerequisite) {
+    ensureDependenciesSorted();
+    int low = 0, high = dependencyCount;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        const DependencyEdge *e = &dependencies[mid];
+        if (e->task < task || (e->task == task && e->prerequisite < prerequisite)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+bool hasDependency(int task, int prerequisite) {
+    int i = dependencyLowerBound(task, prerequisite);
+    return i < dependencyCount && dependencies[i].task == task && dependencies[i].prerequisite == prerequisite;
+}
+
+bool reserveDependencies(int needed) {
+    if (needed <= dependencyCapacity) {
+        return true;
+    }
+    int newCapacity = dependencyCapacity > 0 ? dependencyCapacity : INITIAL_INDEX_CAPACITY;
+    while (newCapacity < needed) {
+        if (newCapacity > INT_MAX / 2) {
+            return false;
+        }
+        newCapacity *= 2;
+    }
+    DependencyEdge *grown = (DependencyEdge*)realloc(dependencies, (size_t)newCapacity * sizeof(DependencyEdge));
+    if (grown == NULL) {
+        printf("Memory allocation error\n");
+        return false;
+    }
+    dependencies = grown;
+    dependencyCapacity = newCapacity;
+    return true;
+}
+
+// Grow dependsOn()'s scratch to cover every slot plus the starting task
+bool reserveDependencyScratch(int needed) {
+    if (needed <= dependencyScratchCapacity) {
+        return true;
+    }
+    int newCapacity = dependencyScratchCapacity > 0 ? dependencyScratchCapacity : INITIAL_INDEX_CAPACITY;
+    while (newCapacity < needed) {
+        if (newCapacity > INT_MAX / 2) {
+            return false;
+        }
+        newCapacity *= 2;
+    }
+    
+    // Fresh stamps start at 0, below any generation handed out
+    unsigned int *visits = (unsigned int*)calloc((size_t)newCapacity, sizeof(unsigned int));
+    int *stack = (int*)realloc(dependencyStack, (size_t)newCapacity * sizeof(int));
+    if (stack != NULL) {
+        dependencyStack = stack;
+    }
+    if (visits == NULL || stack == NULL) {
+        printf("Memory allocation error\n");
+        free(visits);
+        return false;
+    }
+    free(dependencyVisits);
+    dependencyVisits = visits;
+    dependencyScratchCapacity = newCapacity;
+    dependencyVisitGeneration = 0;
+    return true;
+}
+
+// Does `task` wait on `target`, directly or through other tasks? A
+// depth-first walk of prerequisites, visiting each task at most once.
+bool dependsOn(int task, int target) {
+    if (!reserveDependencyScratch(taskSlotCount + 1)) {
+        return true;   // refuse the edge rather than risk a cycle
+    }
+    if (++dependencyVisitGeneration == 0) {
+        memset(dependencyVisits, 0, (size_t)dependencyScratchCapacity * sizeof(unsigned int));
+        dependencyVisitGeneration = 1;
+    }
+    unsigned int *visits = dependencyVisits;
+    unsigned int generation = dependencyVisitGeneration;
+    int *stack = dependencyStack;
+    
+    bool found = false;
+    int depth = 0;
+    stack[depth++] = task;
+    while (depth > 0 && !found) {
+        int id = stack[--depth];
+        for (int i = dependencyLowerBound(id, 0); i < dependencyCount && dependencies[i].task == id; i++) {
+            int prerequisite = dependencies[i].prerequisite;
+            int slot = findTaskIndex(prerequisite);
+            if (slot < 0 || visits[slot] == generation) {
+                continue;
+            }
+            if (prerequisite == target) {
+                found = true;
+                break;
+            }
+            visits[slot] = generation;
+            stack[depth++] = prerequisite;
+        }
+    }
+    return found;
+}
+
+// Make `task` wait for `prerequisite`, refusing edges that would form a cycle
+bool addDependency(int task, int prerequisite) {
+    if (task == prerequisite) {
+        printf("Error: A task cannot depend on itself.\n");
+        return false;
+    }
+    if (findTaskIndex(task) < 0 || findTaskIndex(prerequisite) < 0) {
+        printf("Error: Task %d not found.\n", findTaskIndex(task) < 0 ? task : prerequisite);
+        return false;
+    }
+    if (hasDependency(task, prerequisite)) {
+        return true;
+    }
+    if (dependsOn(prerequisite, task)) {
+        printf("Error: Task %d already waits on task %d; the dependency would form a cycle.\n", prerequisite, task);
+        return false;
+    }
+    if (!reserveDependencies(dependencyCount + 1)) {
+        return false;
+    }
+    
+    int i = dependencyLowerBound(task, prerequisite);
+    memmove(&dependencies[i + 1], &dependencies[i], (size_t)(dependencyCount - i) * sizeof(DependencyEdge));
+    dependencies[i].task = task;
+    dependencies[i].prerequisite = prerequisite;
+    dependencyCount++;
+    return true;
+}
+
+// Add an edge from the journal. It passed addDependency()'s checks when it
+// was logged, so it goes on the end without a cycle check or an insert;
+// the next lookup sorts the edges (and drops repeats) once for all of them.
+bool appendDependency(int task, int prerequisite) {
+    if (!reserveDependencies(dependencyCount + 1)) {
+        return false;
+    }
+    dependencies[dependencyCount].task = task;
+    dependencies[dependencyCount].prerequisite = prerequisite;
+    dependencyCount++;
+    dependenciesSorted = false;
+    return true;
+}
+
+bool removeDependency(int task, int prerequisite) {
+    if (!hasDependency(task, prerequisite)) {
+        return false;
+    }
+    int i = dependencyLowerBound(task, prerequisite);
+    memmove(&dependencies[i], &dependencies[i + 1], (size_t)(dependencyCount - i - 1) * sizeof(DependencyEdge));
+    dependencyCount--;
+    return true;
+}
+
+// Write a task's prerequisite IDs (only the unfinished ones if asked) as
+// "3, 5, 8" and return how many there are. Deleted prerequisites are skipped.
+int formatPrerequisites(int task, bool pendingOnly, char *out, size_t size) {
+    int found = 0;
+    size_t length = 0;
+    out[0] = '\0';
+    for (int i = dependencyLowerBound(task, 0); i < dependencyCount && dependencies[i].task == task; i++) {
+        int slot = findTaskIndex(dependencies[i].prerequisite);
+        if (slot < 0 || (pendingOnly && taskCompleted[slot])) {
+            continue;
+        }
+        if (length < size) {
+            int written = snprintf(out + length, size - length, "%s%d", found > 0 ? ", " : "", taskIds[slot]);
+            length += written > 0 ? (size_t)written : 0;
+        }
+        found++;
+    }
+    return found;
+}
+
+void freeDependencies() {
+    free(dependencies);
+    dependencies = NULL;
+    dependencyCount = 0;
+    dependencyCapacity = 0;
+    dependenciesSorted = true;
+    free(dependencyVisits);
+    free(dependencyStack);
+    dependencyVisits = NULL;
+    dependencyStack = NULL;
+    dependencyScratchCapacity = 0;
+    dependencyVisitGeneration = 0;
+}
+
+int compareDependencyEdges(const void *a, const void *b) {
+    const DependencyEdge *x = (const DependencyEdge*)a;
+    const DependencyEdge *y = (const DependencyEdge*)b;
+    if (x->task != y->task) {
+        return x->task < y->task ? -1 : 1;
+    }
+    return (x->prerequisite > y->prerequisite) - (x->prerequisite < y->prerequisite);
+}
+
+// Restore the (task, prerequisite) order after a bulk load, dropping repeats
+void sortDependencies() {
+    dependenciesSorted = true;
+    if (dependencyCount == 0) {
+        return;   // the edge array may not exist yet
+    }
+    qsort(dependencies, dependencyCount, sizeof(DependencyEdge), compareDependencyEdges);
+    int kept = 0;
+    for (int i = 0; i < dependencyCount; i++) {
+        if (kept == 0 || compareDependencyEdges(&dependencies[kept - 1], &dependencies[i]) != 0) {
+            dependencies[kept++] = dependencies[i];
+        }
+    }
+    dependencyCount = kept;
+}
+
+void ensureDependenciesSorted() {
+    if (!dependenciesSorted) {
+        sortDependencies();
+    }
+}
+
+// Empty the store and release it along with every index
+void resetTaskStore() {
+    freeTaskColumns();
+    freeDescriptionArena();
+    freeDependencies();
+    taskCapacity = 0;
+    taskCount = 0;
+    taskSlotCount = 0;
+    nextTaskId = 1;
+    
+    free(freeSlots);
+    freeSlots = NULL;
+    freeSlotCount = 0;
+    freeSlotCapacity = 0;
+    
+    free(idIndexKeys);
+    free(idIndexSlots);
+    idIndexKeys = NULL;
+    idIndexSlots = NULL;
+    idIndexCapacity = 0;
+    idIndexCount = 0;
+    
+    for (int b = 0; b < 3; b++) {
+        free(priorityBuckets[b].slots);
+        memset(&priorityBuckets[b], 0, sizeof(SlotSet));
+    }
+    free(pendingSet.slots);
+    memset(&pendingSet, 0, sizeof(SlotSet));
+    free(bucketPos);
+    free(pendingPos);
+    bucketPos = NULL;
+    pendingPos = NULL;
+    free(createdIndex);
+    createdIndex = NULL;
+    createdIndexCount = 0;
+    createdIndexCapacity = 0;
+    createdIndexStale = 0;
+    createdIndexSorted = true;
+    
+    clearTrigramIndex();
+    free(duplicateTable);
+    duplicateTable = NULL;
+    duplicateTableCapacity = 0;
+    duplicateTableCount = 0;
+    
+    indexesStale = false;
+    trigramIndexStale = false;
+    duplicateIndexStale = false;
+}
+
+// Map a whole file read-only; pages are faulted in as the decoder reaches
+// them. Returns NULL if the file is missing, empty or cannot be mapped.
+void* mapFile(const char *path, size_t *size) {
+    void *base = NULL;
+    *size = 0;
+    
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) {
+            base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        *size = (size_t)fileSize.QuadPart;
+    }
+    CloseHandle(file);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        *size = (size_t)info.st_size;
+        base = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            base = NULL;
+        }
+    }
+    close(fd);
+#endif
+    
+    return base;
+}
+
+void unmapFile(void *base, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(base);
+#else
+    munmap(base, size);
+#endif
+}
+
+// Read a whole file into a malloc'd buffer; NULL if it cannot be opened
+unsigned char* readFile(const char *path, size_t *size) {
+    FILE *file = fopen(path, "rb");
+    *size = 0;
+    if (file == NULL) {
+        return NULL;
+    }
+    
+    size_t capacity = 1 << 16;
+    unsigned char *data = (unsigned char*)malloc(capacity);
+    while (data != NULL) {
+        *size += fread(data + *size, 1, capacity - *size, file);
+        if (*size < capacity) {
+            break;
+        }
+        unsigned char *grown = (unsigned char*)realloc(data, capacity * 2);
+        if (grown == NULL) {
+            free(data);
+            data = NULL;
+            break;
+        }
+        data = grown;
+        capacity *= 2;
+    }
+    fclose(file);
+    
+    if (data == NULL) {
+        printf("Error: Out of memory reading %s.\n", path);
+    }
+    return data;
+}
+
+// Little-endian fixed-width and LEB128 varint encoding for the file format
+void putUint32(unsigned char *p, unsigned int value) {
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+unsigned int getUint32(const unsigned char *p) {
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) |
+           ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+size_t putVarint(unsigned char *p, unsigned long long value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        p[n++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    p[n++] = (unsigned char)value;
+    return n;
+}
+
+bool getVarint(const unsigned char **p, const unsigned char *end, unsigned long long *value) {
+    unsigned long long result = 0;
+    for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+        unsigned char byte = *(*p)++;
+        result |= (unsigned long long)(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Encode the task in a slot: id, priority and completed flag in one byte, duration,
+// created time as a zigzag delta from the previous task in the block, then
+// the description as length + bytes. Returns the bytes written (at most
+// TASK_RECORD_MAX).
+size_t encodeTaskRecord(unsigned char *out, int slot, long long *previousCreated) {
+    size_t n = putVarint(out, (unsigned int)taskIds[slot]);
+    out[n++] = (unsigned char)(((unsigned int)taskPriorities[slot] << 1) | (taskCompleted[slot] ? 1 : 0));
+    n += putVarint(out + n, (unsigned int)taskDurations[slot]);
+    
+    long long delta = (long long)taskCreated[slot] - *previousCreated;
+    *previousCreated = (long long)taskCreated[slot];
+    n += putVarint(out + n, ((unsigned long long)delta << 1) ^ (unsigned long long)(delta >> 63));
+    
+    size_t length = strnlen(taskDescription(slot), MAX_DESCRIPTION - 1);
+    n += putVarint(out + n, length);
+    memcpy(out + n, taskDescription(slot), length);
+    return n + length;
+}
+
+// Decode every field but the description, leaving *p at its `length` bytes
+bool decodeTaskFields(const unsigned char **p, const unsigned char *end, Task *t, long long *previousCreated, size_t *length) {
+    unsigned long long id, duration, delta, textLength;
+    
+    if (!getVarint(p, end, &id) || id == 0 || id >= INT_MAX || *p >= end) {
+        return false;
+    }
+    unsigned char flags = *(*p)++;
+    Priority priority = (Priority)(flags >> 1);
+    if (priority != HIGH && priority != MEDIUM && priority != LOW) {
+        return false;
+    }
+    if (!getVarint(p, end, &duration) || duration > INT_MAX ||
+        !getVarint(p, end, &delta) ||
+        !getVarint(p, end, &textLength) || textLength >= MAX_DESCRIPTION || textLength > (size_t)(end - *p)) {
+        return false;
+    }
+    
+    t->id = (int)id;
+    t->priority = priority;
+    t->completed = (flags & 1) != 0;
+    t->duration = (int)duration;
+    *previousCreated += (long long)(delta >> 1) ^ -(long long)(delta & 1);
+    t->created = (time_t)*previousCreated;
+    *length = (size_t)textLength;
+    return true;
+}
+
+bool decodeTaskRecord(const unsigned char **p, const unsigned char *end, Task *t, long long *previousCreated) {
+    size_t length;
+    if (!decodeTaskFields(p, end, t, previousCreated, &length)) {
+        return false;
+    }
+    memcpy(t->description, *p, length);
+    t->description[length] = '\0';
+    *p += length;
+    return true;
+}
+
+// Files written before the versioned format are a raw [nextTaskId][count]
+// header followed by Task structs in this build's layout
+void decodeLegacySnapshot(const char *path, const unsigned char *data, size_t size) {
+    int header[2] = {1, 0};
+    if (size >= sizeof(header)) {
+        memcpy(header, data, sizeof(header));
+    }
+    
+    size_t available = size >= sizeof(header) ? (size - sizeof(header)) / sizeof(Task) : 0;
+    if (size < sizeof(header) || header[1] < 0) {
+        printf("Error: %s is corrupt. Starting with empty task list.\n", path);
+        return;
+    }
+    if ((size_t)header[1] > available) {
+        printf("Warning: %s is truncated. Loaded %d of %d tasks.\n", path, (int)available, header[1]);
+        header[1] = (int)available;
+    }
+    if (!reserveTasks(header[1])) {
+        return;
+    }
+    
+    nextTaskId = header[0];
+    for (int i = 0; i < header[1]; i++) {
+        Task t;
+        memcpy(&t, data + sizeof(header) + (size_t)i * sizeof(Task), sizeof(Task));
+        t.description[MAX_DESCRIPTION - 1] = '\0';
+        storeTaskAt(i, &t);
+    }
+    taskCount = header[1];
+    taskSlotCount = taskCount;
+}
+
+// Threads worth starting for a load or index rebuild over this many tasks
+int parallelLoadThreads(int tasks) {
+    int threads = loadThreadCount > 0 ? loadThreadCount : processorCount();
+    if (threads > tasks / (PARALLEL_LOAD_THRESHOLD / 2)) {
+        threads = tasks / (PARALLEL_LOAD_THRESHOLD / 2);
+    }
+    return threads > 1 ? threads : 1;
+}
+
+// Run body once per element of args on its own thread and wait for all of
+// them (argSize 0 hands every thread the same args). A thread that cannot be
+// started runs its share on the caller instead.
+void runOnThreads(void *(*body)(void*), void *args, size_t argSize, int threads) {
+    pthread_t *workers = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+    bool *started = (bool*)calloc((size_t)threads, sizeof(bool));
+    
+    for (int t = 0; t < threads; t++) {
+        void *arg = (char*)args + (size_t)t * argSize;
+        if (workers != NULL && started != NULL) {
+            started[t] = pthread_create(&workers[t], NULL, body, arg) == 0;
+        }
+        if (started == NULL || !started[t]) {
+            body(arg);
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        if (started != NULL && started[t]) {
+            pthread_join(workers[t], NULL);
+        }
+    }
+    free(workers);
+    free(started);
+}
+
+// Check one block's CRC and decode its tasks straight into their slots. The
+// descriptions are only located and hashed; interning them is left to the
+// caller, since the arena and intern table are not shared between threads.
+bool decodeSnapshotBlock(SnapshotBlock *block, DescriptionRef *descriptions) {
+    if (crc32c(0, block->start, block->bytes) != block->crc) {
+        return false;
+    }
+    
+    const unsigned char *p = block->start;
+    const unsigned char *blockEnd = p + block->bytes;
+    long long previousCreated = 0;
+    for (unsigned int i = 0; i < block->tasks; i++) {
+        int slot = block->firstSlot + (int)i;
+        Task t;
+        size_t length;
+        if (!decodeTaskFields(&p, blockEnd, &t, &previousCreated, &length)) {
+            return false;
+        }
+        taskIds[slot] = t.id;
+        taskPriorities[slot] = t.priority;
+        taskDurations[slot] = t.duration;
+        taskCreated[slot] = t.created;
+        taskCompleted[slot] = t.completed;
+        descriptions[slot].text = p;
+        descriptions[slot].length = (unsigned int)length;
+        descriptions[slot].hash = hashDescription((const char*)p, length);
+        p += length;
+    }
+    return p == blockEnd;
+}
+
+void* decodeBlocksThread(void *arg) {
+    SnapshotDecode *decode = (SnapshotDecode*)arg;
+    int b;
+    while ((b = atomic_fetch_add_explicit(&decode->nextBlock, 1, memory_order_relaxed)) < decode->blockCount) {
+        decode->blocks[b].valid = decodeSnapshotBlock(&decode->blocks[b], decode->descriptions);
+    }
+    return NULL;
+}
+
+// Decode the blocks of a snapshot on several threads. A serial walk over the
+// block headers finds where each block starts and which slot its first task
+// lands in; threads then claim blocks, check and decode them, and a final
+// serial pass interns the descriptions in slot order. The result matches the
+// serial decoder's, including stopping at the first bad block. Returns false
+// without touching the store if the working memory cannot be had.
+bool decodeBlocksInParallel(const unsigned char **p, const unsigned char *end, unsigned int storedCount, int threads, bool *damaged) {
+    int blockCapacity = (int)(storedCount / SNAPSHOT_BLOCK_TASKS) + 1;
+    SnapshotBlock *blocks = (SnapshotBlock*)malloc((size_t)blockCapacity * sizeof(SnapshotBlock));
+    DescriptionRef *descriptions = (DescriptionRef*)malloc((size_t)storedCount * sizeof(DescriptionRef));
+    if (blocks == NULL || descriptions == NULL) {
+        free(blocks);
+        free(descriptions);
+        return false;
+    }
+    
+    const unsigned char *q = *p;
+    unsigned int found = 0;
+    int blockCount = 0;
+    bool truncated = false;
+    while (found < storedCount) {
+        if ((size_t)(end - q) < SNAPSHOT_BLOCK_HEADER_SIZE) {
+            truncated = true;
+            break;
+        }
+        unsigned int blockTasks = getUint32(q);
+        unsigned int blockBytes = getUint32(q + 4);
+        if (blockTasks == 0 || blockTasks > storedCount - found ||
+            blockBytes > (size_t)(end - q) - SNAPSHOT_BLOCK_HEADER_SIZE) {
+            truncated = true;
+            break;
+        }
+        if (blockCount == blockCapacity) {
+            SnapshotBlock *grown = (SnapshotBlock*)realloc(blocks, (size_t)blockCapacity * 2 * sizeof(SnapshotBlock));
+            if (grown == NULL) {
+                free(blocks);
+                free(descriptions);
+                return false;
+            }
+            blocks = grown;
+            blockCapacity *= 2;
+        }
+        
+        SnapshotBlock *block = &blocks[blockCount++];
+        block->start = q + SNAPSHOT_BLOCK_HEADER_SIZE;
+        block->tasks = blockTasks;
+        block->bytes = blockBytes;
+        block->crc = getUint32(q + 8);
+        block->firstSlot = (int)found;
+        block->valid = false;
+        found += blockTasks;
+        q = block->start + blockBytes;
+    }
+    
+    SnapshotDecode decode;
+    decode.blocks = blocks;
+    decode.blockCount = blockCount;
+    atomic_init(&decode.nextBlock, 0);
+    decode.descriptions = descriptions;
+    
+    // Every thread works off the same claim counter
+    runOnThreads(decodeBlocksThread, &decode, 0, threads);
+    
+    // Keep the blocks up to the first one that failed
+    int good = 0;
+    while (good < blockCount && blocks[good].valid) {
+        good++;
+    }
+    taskCount = good < blockCount ? blocks[good].firstSlot : (int)found;
+    *damaged = truncated || good < blockCount;
+    *p = good > 0 ? blocks[good - 1].start + blocks[good - 1].bytes : *p;
+    
+    for (int slot = 0; slot < taskCount; slot++) {
+        taskDescriptionOffsets[slot] = internDescriptionText((const char*)descriptions[slot].text,
+                                                             descriptions[slot].length, descriptions[slot].hash);
+    }
+    
+    free(blocks);
+    free(descriptions);
+    return true;
+}
+
+// Decode a versioned snapshot into the store. Every block is checked
+// against its CRC32C before it is decoded; loading stops at the first bad
+// or missing block and keeps the tasks before it.
+void decodeSnapshot(const char *path, const unsigned char *data, size_t size) {
+    if (size < SNAPSHOT_HEADER_SIZE ||
+        crc32c(0, data, SNAPSHOT_HEADER_SIZE - 4) != getUint32(data + SNAPSHOT_HEADER_SIZE - 4)) {
+        printf("Error: %s is corrupt. Starting with empty task list.\n", path);
+        return;
+    }
+    
+    unsigned int version = data[4] | (data[5] << 8);
+    if (version > SNAPSHOT_VERSION) {
+        printf("Error: %s uses format version %u; this build reads up to %d.\n", path, version, SNAPSHOT_VERSION);
+        return;
+    }
+    
+    unsigned int storedNextId = getUint32(data + 8);
+    unsigned int storedCount = getUint32(data + 12);
+    if (storedNextId == 0 || storedNextId > INT_MAX || storedCount > INT_MAX ||
+        !reserveTasks((int)storedCount)) {
+        printf("Error: %s is corrupt. Starting with empty task list.\n", path);
+        return;
+    }
+    nextTaskId = (int)storedNextId;
+    
+    const unsigned char *p = data + SNAPSHOT_HEADER_SIZE;
+    const unsigned char *end = data + size;
+    bool damaged = false;
+    int threads = parallelLoadThreads((int)storedCount);
+    bool decoded = threads > 1 && decodeBlocksInParallel(&p, end, storedCount, threads, &damaged);
+    
+    while (!decoded && (unsigned int)taskCount < storedCount) {
+        if ((size_t)(end - p) < SNAPSHOT_BLOCK_HEADER_SIZE) {
+            damaged = true;
+            break;
+        }
+        unsigned int blockTasks = getUint32(p);
+        unsigned int blockBytes = getUint32(p + 4);
+        unsigned int blockCrc = getUint32(p + 8);
+        p += SNAPSHOT_BLOCK_HEADER_SIZE;
+        
+        if (blockTasks == 0 || blockTasks > storedCount - (unsigned int)taskCount ||
+            blockBytes > (size_t)(end - p) || crc32c(0, p, blockBytes) != blockCrc) {
+            damaged = true;
+            break;
+        }
+        
+        const unsigned char *blockEnd = p + blockBytes;
+        long long previousCreated = 0;
+        int blockStart = taskCount;
+        for (unsigned int i = 0; i < blockTasks; i++) {
+            Task t;
+            if (!decodeTaskRecord(&p, blockEnd, &t, &previousCreated)) {
+                damaged = true;
+                break;
+            }
+            storeTaskAt(taskCount++, &t);
+        }
+        if (damaged || p != blockEnd) {
+            taskCount = blockStart;
+            damaged = true;
+            break;
+        }
+    }
+    
+    taskSlotCount = taskCount;
+    if (damaged) {
+        printf("Warning: %s is damaged or truncated. Loaded %d of %u tasks.\n", path, taskCount, storedCount);
+    } else if (version >= 2) {
+        decodeDependencySection(path, p, end);
+    }
+}
+
+// Decode the dependency section that follows the task blocks. The section is
+// checked as a whole; a bad one is dropped and the tasks are kept.
+void decodeDependencySection(const char *path, const unsigned char *p, const unsigned char *end) {
+    if ((size_t)(end - p) < SNAPSHOT_BLOCK_HEADER_SIZE) {
+        printf("Warning: %s is missing its dependency section.\n", path);
+        return;
+    }
+    unsigned int edgeCount = getUint32(p);
+    unsigned int edgeBytes = getUint32(p + 4);
+    unsigned int edgeCrc = getUint32(p + 8);
+    p += SNAPSHOT_BLOCK_HEADER_SIZE;
+    if (edgeBytes > (size_t)(end - p) || edgeCount > edgeBytes / 2 || crc32c(0, p, edgeBytes) != edgeCrc ||
+        !reserveDependencies((int)edgeCount)) {
+        printf("Warning: %s has a damaged dependency section; dependencies were not loaded.\n", path);
+        return;
+    }
+    
+    const unsigned char *sectionEnd = p + edgeBytes;
+    unsigned long long task = 0;
+    for (unsigned int i = 0; i < edgeCount; i++) {
+        unsigned long long delta, prerequisite;
+        if (!getVarint(&p, sectionEnd, &delta) || !getVarint(&p, sectionEnd, &prerequisite) ||
+            task + delta > INT_MAX || prerequisite == 0 || prerequisite > INT_MAX) {
+            printf("Warning: %s has a damaged dependency section; dependencies were not loaded.\n", path);
+            dependencyCount = 0;
+            return;
+        }
+        task += delta;
+        dependencies[dependencyCount].task = (int)task;
+        dependencies[dependencyCount].prerequisite = (int)prerequisite;
+        dependencyCount++;
+    }
+    sortDependencies();
+}
+
+// Load a snapshot written by saveTasksToFile(), decoding it straight out of
+// a mapping when asked. Returns the number of tasks loaded, or -1 when the
+// file does not exist.
+int loadSnapshot(const char *path, bool useMapping) {
+    resetTaskStore();
+    
+    size_t size = 0;
+    void *data = useMapping ? mapFile(path, &size) : NULL;
+    bool mapped = data != NULL;
+    if (!mapped) {
+        data = readFile(path, &size);
+        if (data == NULL) {
+            return -1;
+        }
+    }
+    
+    if (size >= 4 && memcmp(data, SNAPSHOT_MAGIC, 4) == 0) {
+        decodeSnapshot(path, (const unsigned char*)data, size);
+    } else {
+        decodeLegacySnapshot(path, (const unsigned char*)data, size);
+    }
+    if (mapped) {
+        unmapFile(data, size);
+    } else {
+        free(data);
+    }
+    
+    indexesStale = taskCount > 0;
+    trigramIndexStale = indexesStale;
+    duplicateIndexStale = indexesStale;
+    return taskCount;
+}
+
+
+// Build the ID and secondary indexes if a load left them for later
+void ensureIndexes() {
+    if (!indexesStale) {
+        return;
+    }
+    indexesStale = false;
+    rebuildIdIndex();
+    rebuildSecondaryIndexes();
+}
+
+// Add a task, reusing a tombstoned slot if one is free, else appending to the end
+bool appendTask(const Task *t) {
+    ensureIndexes();
+    if (freeSlotCount == 0 && (taskSlotCount == INT_MAX || !reserveTasks(taskSlotCount + 1))) {
+        return false;
+    }
+    
+    if (!reserveIdIndex(idIndexCount + 1)) {
+        return false;
+    }
+    
+    if (!addCreatedEntry(t)) {
+        return false;
+    }
+    
+    int slot = freeSlotCount > 0 ? freeSlots[--freeSlotCount] : taskSlotCount++;
+    storeTaskAt(slot, t);
+    idIndexPut(t->id, slot);
+    indexTaskSlot(slot);
+    trigramIndexAdd(t->id, t->description);
+    duplicateIndexAdd(slot);
+    taskCount++;
+    return true;
+}
+
+// Delete the task in a slot in O(1): tombstone it and remember the slot for reuse
+void removeTaskAt(int slot) {
+    ensureIndexes();
+    unindexTaskSlot(slot);
+    duplicateIndexRemove(slot);
+    idIndexRemove(taskIds[slot]);
+    taskIds[slot] = 0;
+    taskCount--;
+    trigramIndexRemove(taskDescription(slot));
+    releaseDescription(taskDescriptionOffsets[slot]);
+    taskDescriptionOffsets[slot] = 0;
+    
+    if (freeSlotCount == freeSlotCapacity) {
+        int newCapacity = freeSlotCapacity > 0 ? freeSlotCapacity * 2 : INITIAL_INDEX_CAPACITY;
+        int *grown = (int*)realloc(freeSlots, (size_t)newCapacity * sizeof(int));
+        if (grown == NULL) {
+            // No room to track the tombstone; fall back to compacting it away
+            createdIndexStale++;
+            compactTasks();
+            return;
+        }
+        freeSlots = grown;
+        freeSlotCapacity = newCapacity;
+    }
+    freeSlots[freeSlotCount++] = slot;
+    
+    // The created-time index drops deleted IDs lazily, in bulk
+    if (++createdIndexStale > INITIAL_INDEX_CAPACITY && createdIndexStale * 2 > createdIndexCount) {
+        purgeCreatedIndex();
+    }
+    
+    // Compact once tombstones make up half the slots; each compaction is paid
+    // for by the deletes that preceded it, so deletes stay O(1) amortized
+    if (freeSlotCount >= COMPACT_MIN_DELETED && freeSlotCount * 2 >= taskSlotCount) {
+        compactTasks();
+    } else {
+        compactDescriptionsIfNeeded();
+    }
+}
+
+// Squeeze out tombstones, keeping the remaining tasks in order
+void compactTasks() {
+    if (taskSlotCount == taskCount) {
+        freeSlotCount = 0;
+        return;
+    }
+    
+    int live = 0;
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] != 0) {
+            if (i != live) {
+                moveTaskSlot(live, i);
+            }
+            live++;
+        }
+    }
+    
+    taskSlotCount = live;
+    freeSlotCount = 0;
+    compactDescriptionArena();
+    rebuildIdIndex();
+    shrinkTasks();
+    rebuildSecondaryIndexes();
+}
+
+// Fibonacci hashing spreads sequential IDs across the table
+unsigned int hashTaskId(int id) {
+    return (unsigned int)id * 2654435769u;
+}
+
+// Keep the ID index at most half full so probes stay short
+bool reserveIdIndex(int needed) {
+    if (needed * 2 <= idIndexCapacity) {
+        return true;
+    }
+    
+    int newCapacity = idIndexCapacity > 0 ? idIndexCapacity : INITIAL_INDEX_CAPACITY;
+    while (newCapacity < needed * 2) {
+        if (newCapacity > INT_MAX / 2) {
+            printf("Error: Task ID index cannot grow further.\n");
+            return false;
+        }
+        newCapacity *= 2;
+    }
+    
+    int *newKeys = (int*)calloc(newCapacity, sizeof(int));
+    int *newSlots = (int*)malloc((size_t)newCapacity * sizeof(int));
+    if (newKeys == NULL || newSlots == NULL) {
+        printf("Error: Out of memory growing task ID index.\n");
+        free(newKeys);
+        free(newSlots);
+        return false;
+    }
+    
+    int *oldKeys = idIndexKeys;
+    int *oldSlots = idIndexSlots;
+    int oldCapacity = idIndexCapacity;
+    
+    idIndexKeys = newKeys;
+    idIndexSlots = newSlots;
+    idIndexCapacity = newCapacity;
+    idIndexCount = 0;
+    
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldKeys[i] != 0) {
+            idIndexPut(oldKeys[i], oldSlots[i]);
+        }
+    }
+    
+    free(oldKeys);
+    free(oldSlots);
+    return true;
+}
+
+// Insert or update the slot for an ID (capacity must already be reserved)
+void idIndexPut(int id, int slot) {
+    unsigned int mask = (unsigned int)idIndexCapacity - 1;
+    unsigned int i = hashTaskId(id) & mask;
+    
+    while (idIndexKeys[i] != 0 && idIndexKeys[i] != id) {
+        i = (i + 1) & mask;
+    }
+    
+    if (idIndexKeys[i] == 0) {
+        idIndexKeys[i] = id;
+        idIndexCount++;
+    }
+    idIndexSlots[i] = slot;
+}
+
+// Remove an ID, shifting later entries of the probe chain back into the gap
+void idIndexRemove(int id) {
+    if (idIndexCapacity == 0) {
+        return;
+    }
+    
+    unsigned int mask = (unsigned int)idIndexCapacity - 1;
+    unsigned int i = hashTaskId(id) & mask;
+    
+    while (idIndexKeys[i] != id) {
+        if (idIndexKeys[i] == 0) {
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    
+    unsigned int gap = i;
+    for (unsigned int j = (gap + 1) & mask; idIndexKeys[j] != 0; j = (j + 1) & mask) {
+        unsigned int home = hashTaskId(idIndexKeys[j]) & mask;
+        // Move the entry back only if its home slot is not between the gap and j
+        if (((j - home) & mask) >= ((j - gap) & mask)) {
+            idIndexKeys[gap] = idIndexKeys[j];
+            idIndexSlots[gap] = idIndexSlots[j];
+            gap = j;
+        }
+    }
+    
+    idIndexKeys[gap] = 0;
+    idIndexCount--;
+}
+
+// Cut the slot range into one share per thread of an index rebuild
+IndexRange* splitSlotRanges(int threads) {
+    IndexRange *ranges = (IndexRange*)calloc((size_t)threads, sizeof(IndexRange));
+    if (ranges == NULL) {
+        return NULL;
+    }
+    for (int t = 0; t < threads; t++) {
+        ranges[t].first = (int)((long long)taskSlotCount * t / threads);
+        ranges[t].end = (int)((long long)taskSlotCount * (t + 1) / threads);
+    }
+    return ranges;
+}
+
+// Insert a range of slots into the presized ID index. Threads claim empty
+// keys with a compare-and-swap; an ID is only ever written to one entry,
+// so the slot beside it needs no further synchronisation.
+void* idIndexThread(void *arg) {
+    IndexRange *range = (IndexRange*)arg;
+    _Atomic int *keys = (_Atomic int*)idIndexKeys;
+    unsigned int mask = (unsigned int)idIndexCapacity - 1;
+    
+    for (int slot = range->first; slot < range->end; slot++) {
+        int id = taskIds[slot];
+        if (id == 0) {
+            continue;
+        }
+        unsigned int i = hashTaskId(id) & mask;
+        for (;;) {
+            int expected = 0;
+            if (atomic_compare_exchange_strong_explicit(&keys[i], &expected, id,
+                                                        memory_order_relaxed, memory_order_relaxed)) {
+                range->inserted++;
+                break;
+            }
+            if (expected == id) {
+                break;
+            }
+            i = (i + 1) & mask;
+        }
+        idIndexSlots[i] = slot;
+    }
+    return NULL;
+}
+
+// Recreate the index after tasks have moved (load, sort). Large stores are
+// indexed by several threads at once.
+void rebuildIdIndex() {
+    if (idIndexCapacity > 0) {
+        memset(idIndexKeys, 0, (size_t)idIndexCapacity * sizeof(int));
+    }
+    idIndexCount = 0;
+    
+    if (!reserveIdIndex(taskCount)) {
+        return;
+    }
+    
+    int threads = parallelLoadThreads(taskSlotCount);
+    IndexRange *ranges = threads > 1 ? splitSlotRanges(threads) : NULL;
+    if (ranges != NULL) {
+        runOnThreads(idIndexThread, ranges, sizeof(IndexRange), threads);
+        for (int t = 0; t < threads; t++) {
+            idIndexCount += ranges[t].inserted;
+        }
+        free(ranges);
+        return;
+    }
+    
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] != 0) {
+            idIndexPut(taskIds[i], i);
+        }
+    }
+}
+
+// Find the slot holding a task ID, or -1 if there is no such task
+int findTaskIndex(int id) {
+    ensureIndexes();
+    if (id == 0 || idIndexCapacity == 0) {
+        return -1;
+    }
+    
+    unsigned int mask = (unsigned int)idIndexCapacity - 1;
+    unsigned int i = hashTaskId(id) & mask;
+    
+    while (idIndexKeys[i] != 0) {
+        if (idIndexKeys[i] == id) {
+            return idIndexSlots[i];
+        }
+        i = (i + 1) & mask;
+    }
+    return -1;
+}
+
+// Per-slot position arrays follow the task store's capacity
+bool resizeSlotPositions(int capacity) {
+    int *newBucketPos = (int*)realloc(bucketPos, (size_t)capacity * sizeof(int));
+    if (newBucketPos == NULL) {
+        return false;
+    }
+    bucketPos = newBucketPos;
+    
+    int *newPendingPos = (int*)realloc(pendingPos, (size_t)capacity * sizeof(int));
+    if (newPendingPos == NULL) {
+        return false;
+    }
+    pendingPos = newPendingPos;
+    return true;
+}
+
+// Bucket number for a priority: High, Medium, Low
+int priorityBucket(Priority p) {
+    switch (p) {
+        case HIGH: return 0;
+        case MEDIUM: return 1;
+        default: return 2;
+    }
+}
+
+// Add a slot to a set. If the set cannot grow the slot is left out, with
+// position -1 so a later remove knows there is nothing to take out.
+bool slotSetAdd(SlotSet *set, int *positions, int slot) {
+    if (set->count == set->capacity) {
+        int newCapacity = set->capacity > 0 ? set->capacity * 2 : INITIAL_INDEX_CAPACITY;
+        int *grown = (int*)realloc(set->slots, (size_t)newCapacity * sizeof(int));
+        if (grown == NULL) {
+            printf("Error: Out of memory growing task index.\n");
+            positions[slot] = -1;
+            return false;
+        }
+        set->slots = grown;
+        set->capacity = newCapacity;
+    }
+    
+    positions[slot] = set->count;
+    set->slots[set->count++] = slot;
+    return true;
+}
+
+// Swap-remove: the last member takes over the removed slot's position.
+// A slot that is not in the set (position -1) is ignored.
+void slotSetRemove(SlotSet *set, int *positions, int slot) {
+    int pos = positions[slot];
+    if (pos < 0) {
+        return;
+    }
+    int last = set->slots[--set->count];
+    set->slots[pos] = last;
+    positions[last] = pos;
+    positions[slot] = -1;
+}
+
+// Add a live slot to its priority bucket and, if not completed, the pending set
+void indexTaskSlot(int slot) {
+    slotSetAdd(&priorityBuckets[priorityBucket(taskPriorities[slot])], bucketPos, slot);
+    pendingPos[slot] = -1;
+    if (!taskCompleted[slot]) {
+        slotSetAdd(&pendingSet, pendingPos, slot);
+    }
+}
+
+void unindexTaskSlot(int slot) {
+    slotSetRemove(&priorityBuckets[priorityBucket(taskPriorities[slot])], bucketPos, slot);
+    slotSetRemove(&pendingSet, pendingPos, slot);
+}
+
+// Record a new task in created-time order; new tasks are almost always the newest
+bool addCreatedEntry(const Task *t) {
+    if (createdIndexCount == createdIndexCapacity) {
+        int newCapacity = createdIndexCapacity > 0 ? createdIndexCapacity * 2 : INITIAL_INDEX_CAPACITY;
+        CreatedEntry *grown = (CreatedEntry*)realloc(createdIndex, (size_t)newCapacity * sizeof(CreatedEntry));
+        if (grown == NULL) {
+            printf("Error: Out of memory growing created-time index.\n");
+            return false;
+        }
+        createdIndex = grown;
+        createdIndexCapacity = newCapacity;
+    }
+    
+    // Insert behind any newer entries (O(1) for the usual append). An entry
+    // far out of order, as imports of old tasks bring, goes on the end and
+    // the index is sorted once when next read.
+    CreatedEntry entry = {t->created, t->id};
+    int pos = createdIndexCount;
+    while (pos > 0 && compareCreatedEntries(&createdIndex[pos - 1], &entry) > 0) {
+        if (createdIndexCount - pos == CREATED_INSERT_SCAN) {
+            pos = createdIndexCount;
+            createdIndexSorted = false;
+            break;
+        }
+        pos--;
+    }
+    memmove(&createdIndex[pos + 1], &createdIndex[pos], (size_t)(createdIndexCount - pos) * sizeof(CreatedEntry));
+    createdIndex[pos] = entry;
+    createdIndexCount++;
+    return true;
+}
+
+// Oldest first, ties by ID
+int compareCreatedEntries(const void *a, const void *b) {
+    const CreatedEntry *x = (const CreatedEntry*)a;
+    const CreatedEntry *y = (const CreatedEntry*)b;
+    if (x->created != y->created) return x->created < y->created ? -1 : 1;
+    if (x->id != y->id) return x->id < y->id ? -1 : 1;
+    return 0;
+}
+
+// Drop entries for deleted tasks
+void purgeCreatedIndex() {
+    int kept = 0;
+    for (int i = 0; i < createdIndexCount; i++) {
+        if (findTaskIndex(createdIndex[i].id) >= 0) {
+            createdIndex[kept++] = createdIndex[i];
+        }
+    }
+    createdIndexCount = kept;
+    createdIndexStale = 0;
+}
+
+bool reserveSlotSet(SlotSet *set, int needed) {
+    if (needed <= set->capacity) {
+        return true;
+    }
+    int *grown = (int*)realloc(set->slots, (size_t)needed * sizeof(int));
+    if (grown == NULL) {
+        return false;
+    }
+    set->slots = grown;
+    set->capacity = needed;
+    return true;
+}
+
+// First pass of a parallel rebuild: size this range's share of each index
+void* countIndexThread(void *arg) {
+    IndexRange *range = (IndexRange*)arg;
+    for (int slot = range->first; slot < range->end; slot++) {
+        if (taskIds[slot] != 0) {
+            range->bucketCounts[priorityBucket(taskPriorities[slot])]++;
+            range->pendingCount += !taskCompleted[slot];
+        }
+    }
+    return NULL;
+}
+
+// Second pass: write this range's members at the offsets the counts gave,
+// in slot order, so the sets come out as a serial rebuild leaves them. The
+// range's created-time entries are sorted here as one run of the final merge.
+void* fillIndexThread(void *arg) {
+    IndexRange *range = (IndexRange*)arg;
+    int bucketNext[3] = {range->bucketStart[0], range->bucketStart[1], range->bucketStart[2]};
+    int pendingNext = range->pendingStart;
+    int createdNext = range->createdStart;
+    
+    for (int slot = range->first; slot < range->end; slot++) {
+        if (taskIds[slot] == 0) {
+            continue;
+        }
+        int b = priorityBucket(taskPriorities[slot]);
+        bucketPos[slot] = bucketNext[b];
+        priorityBuckets[b].slots[bucketNext[b]++] = slot;
+        pendingPos[slot] = -1;
+        if (!taskCompleted[slot]) {
+            pendingPos[slot] = pendingNext;
+            pendingSet.slots[pendingNext++] = slot;
+        }
+        if (range->fillCreated) {
+            createdIndex[createdNext].created = taskCreated[slot];
+            createdIndex[createdNext].id = taskIds[slot];
+            createdNext++;
+        }
+    }
+    
+    if (range->fillCreated) {
+        qsort(createdIndex + range->createdStart, (size_t)(createdNext - range->createdStart),
+              sizeof(CreatedEntry), compareCreatedEntries);
+    }
+    return NULL;
+}
+
+void mergeCreatedRuns(const CreatedEntry *left, int leftCount, const CreatedEntry *right, int rightCount, CreatedEntry *out) {
+    int i = 0, j = 0, k = 0;
+    while (i < leftCount && j < rightCount) {
+        if (compareCreatedEntries(&right[j], &left[i]) < 0) {
+            out[k++] = right[j++];
+        } else {
+            out[k++] = left[i++];
+        }
+    }
+    while (i < leftCount) out[k++] = left[i++];
+    while (j < rightCount) out[k++] = right[j++];
+}
+
+void* mergeCreatedThread(void *arg) {
+    CreatedMerge *merge = (CreatedMerge*)arg;
+    mergeCreatedRuns(merge->left, merge->leftCount, merge->right, merge->rightCount, merge->out);
+    return NULL;
+}
+
+// Merge the sorted runs of the created-time index pairwise, each level's
+// merges in parallel, as the sort engine does. `bounds` holds runs + 1
+// entries and is overwritten.
+bool mergeCreatedIndex(const int *bounds, int runs) {
+    CreatedEntry *scratch = (CreatedEntry*)malloc((size_t)(createdIndexCount > 0 ? createdIndexCount : 1) * sizeof(CreatedEntry));
+    CreatedMerge *merges = (CreatedMerge*)malloc((size_t)runs * sizeof(CreatedMerge));
+    int *edges = (int*)malloc((size_t)(runs + 1) * sizeof(int));
+    if (scratch == NULL || merges == NULL || edges == NULL) {
+        free(scratch);
+        free(merges);
+        free(edges);
+        return false;
+    }
+    memcpy(edges, bounds, (size_t)(runs + 1) * sizeof(int));
+    
+    CreatedEntry *from = createdIndex;
+    CreatedEntry *to = scratch;
+    while (runs > 1) {
+        int merged = 0;
+        for (int r = 0; r < runs; r += 2) {
+            int start = edges[r];
+            int middle = edges[r + 1];
+            int end = r + 2 <= runs ? edges[r + 2] : middle;
+            merges[merged].left = from + start;
+            merges[merged].leftCount = middle - start;
+            merges[merged].right = from + middle;
+            merges[merged].rightCount = end - middle;
+            merges[merged].out = to + start;
+            merged++;
+        }
+        runOnThreads(mergeCreatedThread, merges, sizeof(CreatedMerge), merged);
+        
+        for (int r = 0, m = 0; r <= runs; r += 2, m++) {
+            edges[m] = edges[r];
+        }
+        if (runs % 2 == 1) {
+            edges[merged] = createdIndexCount;
+        }
+        runs = merged;
+        
+        CreatedEntry *swap = from;
+        from = to;
+        to = swap;
+    }
+    
+    if (from != createdIndex) {
+        memcpy(createdIndex, from, (size_t)createdIndexCount * sizeof(CreatedEntry));
+    }
+    free(scratch);
+    free(merges);
+    free(edges);
+    return true;
+}
+
+// Rebuild the priority buckets, pending set and (when out of step) the
+// created-time index from slot ranges on several threads: count, size every
+// index once, then fill. Returns false, with the indexes untouched, if the
+// memory for that cannot be had.
+bool rebuildSecondaryIndexesInParallel(int threads) {
+    IndexRange *ranges = splitSlotRanges(threads);
+    int *bounds = (int*)malloc((size_t)(threads + 1) * sizeof(int));
+    if (ranges == NULL || bounds == NULL) {
+        free(ranges);
+        free(bounds);
+        return false;
+    }
+    runOnThreads(countIndexThread, ranges, sizeof(IndexRange), threads);
+    
+    int bucketTotals[3] = {0, 0, 0};
+    int pendingTotal = 0;
+    int liveTotal = 0;
+    for (int t = 0; t < threads; t++) {
+        bounds[t] = liveTotal;
+        for (int b = 0; b < 3; b++) {
+            ranges[t].bucketStart[b] = bucketTotals[b];
+            bucketTotals[b] += ranges[t].bucketCounts[b];
+            liveTotal += ranges[t].bucketCounts[b];
+        }
+        ranges[t].pendingStart = pendingTotal;
+        pendingTotal += ranges[t].pendingCount;
+        ranges[t].createdStart = bounds[t];
+    }
+    bounds[threads] = liveTotal;
+    
+    bool rebuildCreated = createdIndexCount - createdIndexStale != taskCount;
+    bool reserved = reserveSlotSet(&priorityBuckets[0], bucketTotals[0]) &&
+                    reserveSlotSet(&priorityBuckets[1], bucketTotals[1]) &&
+                    reserveSlotSet(&priorityBuckets[2], bucketTotals[2]) &&
+                    reserveSlotSet(&pendingSet, pendingTotal);
+    if (reserved && rebuildCreated && createdIndexCapacity < liveTotal) {
+        CreatedEntry *grown = (CreatedEntry*)realloc(createdIndex, (size_t)liveTotal * sizeof(CreatedEntry));
+        reserved = grown != NULL;
+        if (grown != NULL) {
+            createdIndex = grown;
+            createdIndexCapacity = liveTotal;
+        }
+    }
+    if (!reserved) {
+        free(ranges);
+        free(bounds);
+        return false;
+    }
+    
+    for (int t = 0; t < threads; t++) {
+        ranges[t].fillCreated = rebuildCreated;
+    }
+    runOnThreads(fillIndexThread, ranges, sizeof(IndexRange), threads);
+    for (int b = 0; b < 3; b++) {
+        priorityBuckets[b].count = bucketTotals[b];
+    }
+    pendingSet.count = pendingTotal;
+    
+    if (rebuildCreated) {
+        createdIndexCount = liveTotal;
+        createdIndexStale = 0;
+        if (!mergeCreatedIndex(bounds, threads)) {
+            qsort(createdIndex, createdIndexCount, sizeof(CreatedEntry), compareCreatedEntries);
+        }
+        createdIndexSorted = true;
+    } else if (createdIndexStale > 0) {
+        purgeCreatedIndex();
+    }
+    
+    free(ranges);
+    free(bounds);
+    return true;
+}
+
+// Recreate every secondary index from the store (load, compaction, reordering)
+void rebuildSecondaryIndexes() {
+    int threads = parallelLoadThreads(taskSlotCount);
+    if (threads > 1 && rebuildSecondaryIndexesInParallel(threads)) {
+        return;
+    }
+    
+    for (int b = 0; b < 3; b++) {
+        priorityBuckets[b].count = 0;
+    }
+    pendingSet.count = 0;
+    
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] != 0) {
+            indexTaskSlot(i);
+        }
+    }
+    
+    // Created times do not change when tasks move, so only rebuild from scratch
+    // when the index is out of step with the store
+    if (createdIndexCount - createdIndexStale != taskCount) {
+        createdIndexCount = 0;
+        createdIndexStale = 0;
+        if (createdIndexCapacity < taskCount) {
+            CreatedEntry *grown = (CreatedEntry*)realloc(createdIndex, (size_t)taskCount * sizeof(CreatedEntry));
+            if (grown == NULL) {
+                printf("Error: Out of memory building created-time index.\n");
+                return;
+            }
+            createdIndex = grown;
+            createdIndexCapacity = taskCount;
+        }
+        for (int i = 0; i < taskSlotCount; i++) {
+            if (taskIds[i] != 0) {
+                createdIndex[createdIndexCount].created = taskCreated[i];
+                createdIndex[createdIndexCount].id = taskIds[i];
+                createdIndexCount++;
+            }
+        }
+        qsort(createdIndex, createdIndexCount, sizeof(CreatedEntry), compareCreatedEntries);
+        createdIndexSorted = true;
+    } else if (createdIndexStale > 0) {
+        purgeCreatedIndex();
+    }
+}
+
+// Change a task's completion state, keeping the pending set in step
+void setTaskCompleted(int slot, bool completed) {
+    ensureIndexes();
+    if (taskCompleted[slot] == completed) {
+        return;
+    }
+    
+    taskCompleted[slot] = completed;
+    if (completed) {
+        slotSetRemove(&pendingSet, pendingPos, slot);
+    } else {
+        slotSetAdd(&pendingSet, pendingPos, slot);
+    }
+}
+
+// Change a task's priority, moving it to the matching bucket
+void setTaskPriority(int slot, Priority priority) {
+    ensureIndexes();
+    if (taskPriorities[slot] == priority) {
+        return;
+    }
+    
+    slotSetRemove(&priorityBuckets[priorityBucket(taskPriorities[slot])], bucketPos, slot);
+    taskPriorities[slot] = priority;
+    slotSetAdd(&priorityBuckets[priorityBucket(priority)], bucketPos, slot);
+}
+
+int compareInts(const void *a, const void *b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Members of a slot set in list order; the caller frees the result
+int* copySlotSet(const SlotSet *set, int *count) {
+    int *slots = (int*)malloc((size_t)(set->count > 0 ? set->count : 1) * sizeof(int));
+    if (slots == NULL) {
+        printf("Memory allocation error\n");
+        *count = 0;
+        return NULL;
+    }
+    
+    if (set->count > 0) {
+        memcpy(slots, set->slots, (size_t)set->count * sizeof(int));
+        qsort(slots, set->count, sizeof(int), compareInts);
+    }
+    *count = set->count;
+    return slots;
+}
+
+int* pendingTaskSlots(int *count) {
+    ensureIndexes();
+    return copySlotSet(&pendingSet, count);
+}
+
+int* priorityTaskSlots(Priority priority, int *count) {
+    ensureIndexes();
+    return copySlotSet(&priorityBuckets[priorityBucket(priority)], count);
+}
+
+// Slots of live tasks newest first, read straight off the created-time index.
+// Tasks created in the same second keep list order, as a stable sort would.
+int* createdTaskOrder(int *count) {
+    ensureIndexes();
+    if (!createdIndexSorted) {
+        qsort(createdIndex, createdIndexCount, sizeof(CreatedEntry), compareCreatedEntries);
+        createdIndexSorted = true;
+    }
+    int *order = (int*)malloc((size_t)(taskCount > 0 ? taskCount : 1) * sizeof(int));
+    if (order == NULL) {
+        printf("Memory allocation error\n");
+        *count = 0;
+        return NULL;
+    }
+    
+    int n = 0;
+    for (int i = createdIndexCount - 1; i >= 0; ) {
+        int runStart = n;
+        time_t created = createdIndex[i].created;
+        for (; i >= 0 && createdIndex[i].created == created; i--) {
+            int slot = findTaskIndex(createdIndex[i].id);
+            if (slot >= 0) {
+                order[n++] = slot;
+            }
+        }
+        if (n - runStart > 1) {
+            qsort(order + runStart, n - runStart, sizeof(int), compareInts);
+        }
+    }
+    
+    *count = n;
+    return order;
+}
+
+// Three case-folded bytes packed into a 24-bit key
+unsigned int trigramKey(const char *text) {
+    return ((unsigned int)foldCase((unsigned char)text[0]) << 16) |
+           ((unsigned int)foldCase((unsigned char)text[1]) << 8) |
+            (unsigned int)foldCase((unsigned char)text[2]);
+}
+
+// Distinct trigram keys of a string in ascending order; the caller frees *keys
+int collectTrigrams(const char *text, unsigned int **keys) {
+    size_t length = strlen(text);
+    *keys = NULL;
+    if (length < 3) {
+        return 0;
+    }
+    
+    unsigned int *found = (unsigned int*)malloc((length - 2) * sizeof(unsigned int));
+    if (found == NULL) {
+        return 0;
+    }
+    
+    int count = 0;
+    for (size_t i = 0; i + 2 < length; i++) {
+        found[count++] = trigramKey(text + i);
+    }
+    
+    // Insertion sort: descriptions are short, and this runs once per add/edit
+    for (int i = 1; i < count; i++) {
+        unsigned int key = found[i];
+        int j = i - 1;
+        while (j >= 0 && found[j] > key) {
+            found[j + 1] = found[j];
+            j--;
+        }
+        found[j + 1] = key;
+    }
+    
+    int distinct = 0;
+    for (int i = 0; i < count; i++) {
+        if (distinct == 0 || found[distinct - 1] != found[i]) {
+            found[distinct++] = found[i];
+        }
+    }
+    
+    *keys = found;
+    return distinct;
+}
+
+// Posting list for a trigram, or NULL if no description contains it
+TrigramPostings* findTrigram(unsigned int key) {
+    if (trigramTableCapacity == 0) {
+        return NULL;
+    }
+    
+    unsigned int mask = (unsigned int)trigramTableCapacity - 1;
+    unsigned int i = (key * 2654435769u) & mask;
+    while (trigramTable[i].key != TRIGRAM_EMPTY) {
+        if (trigramTable[i].key == key) {
+            return &trigramTable[i];
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+// Posting list for a trigram, created if needed
+TrigramPostings* trigramFor(unsigned int key) {
+    TrigramPostings *postings = findTrigram(key);
+    if (postings != NULL) {
+        return postings;
+    }
+    
+    if ((trigramTableCount + 1) * 2 > trigramTableCapacity) {
+        int newCapacity = trigramTableCapacity > 0 ? trigramTableCapacity * 2 : 1024;
+        TrigramPostings *newTable = (TrigramPostings*)malloc((size_t)newCapacity * sizeof(TrigramPostings));
+        if (newTable == NULL) {
+            printf("Error: Out of memory growing search index.\n");
+            return NULL;
+        }
+        for (int i = 0; i < newCapacity; i++) {
+            newTable[i].key = TRIGRAM_EMPTY;
+        }
+        
+        unsigned int mask = (unsigned int)newCapacity - 1;
+        for (int i = 0; i < trigramTableCapacity; i++) {
+            if (trigramTable[i].key != TRIGRAM_EMPTY) {
+                unsigned int j = (trigramTable[i].key * 2654435769u) & mask;
+                while (newTable[j].key != TRIGRAM_EMPTY) {
+                    j = (j + 1) & mask;
+                }
+                newTable[j] = trigramTable[i];
+            }
+        }
+        
+        free(trigramTable);
+        trigramTable = newTable;
+        trigramTableCapacity = newCapacity;
+    }
+    
+    unsigned int mask = (unsigned int)trigramTableCapacity - 1;
+    unsigned int i = (key * 2654435769u) & mask;
+    while (trigramTable[i].key != TRIGRAM_EMPTY) {
+        i = (i + 1) & mask;
+    }
+    
+    postings = &trigramTable[i];
+    postings->key = key;
+    postings->sorted = true;
+    postings->count = 0;
+    postings->capacity = 0;
+    postings->ids = NULL;
+    trigramTableCount++;
+    return postings;
+}
+
+bool postingAppend(TrigramPostings *postings, int id) {
+    if (postings->count == postings->capacity) {
+        int newCapacity = postings->capacity > 0 ? postings->capacity * 2 : 4;
+        int *grown = (int*)realloc(postings->ids, (size_t)newCapacity * sizeof(int));
+        if (grown == NULL) {
+            printf("Error: Out of memory growing search index.\n");
+            return false;
+        }
+        postings->ids = grown;
+        postings->capacity = newCapacity;
+    }
+    
+    // IDs are handed out in increasing order, so plain adds keep the list sorted
+    if (postings->count > 0 && postings->ids[postings->count - 1] >= id) {
+        postings->sorted = false;
+    }
+    postings->ids[postings->count++] = id;
+    trigramPostingCount++;
+    return true;
+}
+
+// Restore ascending, duplicate-free order after out-of-order appends
+void preparePostings(TrigramPostings *postings) {
+    if (postings->sorted) {
+        return;
+    }
+    
+    qsort(postings->ids, postings->count, sizeof(int), compareInts);
+    int distinct = 0;
+    for (int i = 0; i < postings->count; i++) {
+        if (distinct == 0 || postings->ids[distinct - 1] != postings->ids[i]) {
+            postings->ids[distinct++] = postings->ids[i];
+        }
+    }
+    trigramPostingCount -= postings->count - distinct;
+    postings->count = distinct;
+    postings->sorted = true;
+}
+
+void trigramIndexAdd(int id, const char *description) {
+    if (trigramIndexStale) {
+        return;
+    }
+    unsigned int *keys;
+    int count = collectTrigrams(description, &keys);
+    
+    for (int i = 0; i < count; i++) {
+        TrigramPostings *postings = trigramFor(keys[i]);
+        if (postings != NULL) {
+            postingAppend(postings, id);
+        }
+    }
+    free(keys);
+}
+
+// Deleted IDs stay in their posting lists until the next rebuild; searches
+// verify every candidate, so stale postings only cost a little space
+void trigramIndexRemove(const char *description) {
+    if (trigramIndexStale) {
+        return;
+    }
+    unsigned int *keys;
+    trigramStalePostings += collectTrigrams(description, &keys);
+    free(keys);
+    
+    if (trigramStalePostings > 1024 && trigramStalePostings * 2 > trigramPostingCount) {
+        rebuildTrigramIndex();
+    }
+}
+
+// Index only the trigrams the new description gained; the lost ones go stale
+void trigramIndexReplace(int id, const char *oldDescription, const char *newDescription) {
+    if (trigramIndexStale) {
+        return;
+    }
+    unsigned int *oldKeys, *newKeys;
+    int oldCount = collectTrigrams(oldDescription, &oldKeys);
+    int newCount = collectTrigrams(newDescription, &newKeys);
+    
+    int i = 0, j = 0;
+    while (i < oldCount || j < newCount) {
+        if (j == newCount || (i < oldCount && oldKeys[i] < newKeys[j])) {
+            trigramStalePostings++;
+            i++;
+        } else if (i == oldCount || newKeys[j] < oldKeys[i]) {
+            TrigramPostings *postings = trigramFor(newKeys[j]);
+            if (postings != NULL) {
+                postingAppend(postings, id);
+            }
+            j++;
+        } else {
+            i++;
+            j++;
+        }
+    }
+    
+    free(oldKeys);
+    free(newKeys);
+}
+
+void clearTrigramIndex() {
+    for (int i = 0; i < trigramTableCapacity; i++) {
+        if (trigramTable[i].key != TRIGRAM_EMPTY) {
+            free(trigramTable[i].ids);
+        }
+    }
+    free(trigramTable);
+    trigramTable = NULL;
+    trigramTableCapacity = 0;
+    trigramTableCount = 0;
+    trigramPostingCount = 0;
+    trigramStalePostings = 0;
+}
+
+// Index every live description from scratch (load, or too many stale postings).
+// Walking tasks in ID order keeps every posting list sorted as it is built.
+void rebuildTrigramIndex() {
+    clearTrigramIndex();
+    trigramIndexStale = false;
+    
+    int count = taskCount;
+    int *order = (int*)malloc((size_t)(count > 0 ? count : 1) * sizeof(int));
+    if (order == NULL) {
+        printf("Error: Out of memory building search index.\n");
+        return;
+    }
+    
+    int n = 0;
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] != 0) {
+            order[n++] = taskIds[i];
+        }
+    }
+    qsort(order, n, sizeof(int), compareInts);
+    
+    for (int i = 0; i < n; i++) {
+        int slot = findTaskIndex(order[i]);
+        trigramIndexAdd(taskIds[slot], taskDescription(slot));
+    }
+    free(order);
+}
+
+// Intersect two ascending ID lists. When one is much shorter, gallop through
+// the longer one instead of stepping, so the cost follows the shorter list.
+int intersectIds(const int *a, int aCount, const int *b, int bCount, int *out) {
+    if (aCount > bCount) {
+        const int *t = a; a = b; b = t;
+        int c = aCount; aCount = bCount; bCount = c;
+    }
+    
+    int n = 0, j = 0;
+    for (int i = 0; i < aCount && j < bCount; i++) {
+        if (b[j] < a[i]) {
+            int step = 1;
+            while (j + step < bCount && b[j + step] < a[i]) {
+                j += step;
+                step *= 2;
+            }
+            int high = j + step < bCount ? j + step : bCount - 1;
+            while (j < high) {
+                int mid = j + (high - j) / 2;
+                if (b[mid] < a[i]) j = mid + 1; else high = mid;
+            }
+        }
+        if (j < bCount && b[j] == a[i]) {
+            out[n++] = a[i];
+            j++;
+        }
+    }
+    return n;
+}
+
+// IDs whose description may contain a term (length >= 3): the intersection
+// of the posting lists of the term's trigrams, shortest list first
+int* termCandidates(const char *term, int *count) {
+    unsigned int *keys;
+    int keyCount = collectTrigrams(term, &keys);
+    *count = 0;
+    
+    TrigramPostings **lists = (TrigramPostings**)malloc((size_t)(keyCount > 0 ? keyCount : 1) * sizeof(TrigramPostings*));
+    if (lists == NULL) {
+        free(keys);
+        return NULL;
+    }
+    
+    for (int i = 0; i < keyCount; i++) {
+        lists[i] = findTrigram(keys[i]);
+        if (lists[i] == NULL) {
+            // Some trigram never occurs, so nothing can match
+            free(keys);
+            free(lists);
+            return (int*)malloc(sizeof(int));
+        }
+        preparePostings(lists[i]);
+    }
+    free(keys);
+    
+    for (int i = 1; i < keyCount; i++) {
+        TrigramPostings *list = lists[i];
+        int j = i - 1;
+        while (j >= 0 && lists[j]->count > list->count) {
+            lists[j + 1] = lists[j];
+            j--;
+        }
+        lists[j + 1] = list;
+    }
+    
+    int n = lists[0]->count;
+    int *result = (int*)malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+    if (result == NULL) {
+        free(lists);
+        return NULL;
+    }
+    memcpy(result, lists[0]->ids, (size_t)n * sizeof(int));
+    
+    for (int i = 1; i < keyCount && n > 0; i++) {
+        n = intersectIds(result, n, lists[i]->ids, lists[i]->count, result);
+    }
+    
+    free(lists);
+    *count = n;
+    return result;
+}
+
+// ASCII lower-casing without the locale lookup tolower() does
+int foldCase(int c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+bool equalsIgnoreCase(const char *a, const char *b, size_t length) {
+    for (size_t k = 0; k < length; k++) {
+        if (foldCase((unsigned char)a[k]) != foldCase((unsigned char)b[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Portable fallback: check the first byte before comparing the rest
+const char* findIgnoreCaseScalar(const char *haystack, size_t haystackLength, const char *needle, size_t needleLength) {
+    if (needleLength > haystackLength) {
+        return NULL;
+    }
+    
+    int first = foldCase((unsigned char)needle[0]);
+    for (size_t i = 0; i + needleLength <= haystackLength; i++) {
+        if (foldCase((unsigned char)haystack[i]) == first &&
+            equalsIgnoreCase(haystack + i + 1, needle + 1, needleLength - 1)) {
+            return haystack + i;
+        }
+    }
+    return NULL;
+}
+
+#ifdef HAVE_X86_SIMD
+// Compare the needle's first and last bytes against 16 haystack positions at
+// once, then verify only the positions where both agree. Both sides are
+// OR-ed with 0x20, which folds letters to lower case; for other bytes the
+// filter may pass extra positions, which the full comparison rejects.
+__attribute__((target("sse2")))
+const char* findIgnoreCaseSse2(const char *haystack, size_t haystackLength, const char *needle, size_t needleLength) {
+    if (needleLength > haystackLength) {
+        return NULL;
+    }
+    
+    const __m128i fold = _mm_set1_epi8(0x20);
+    const __m128i first = _mm_set1_epi8((char)(needle[0] | 0x20));
+    const __m128i last = _mm_set1_epi8((char)(needle[needleLength - 1] | 0x20));
+    
+    size_t i = 0;
+    for (; i + needleLength - 1 + 16 <= haystackLength; i += 16) {
+        __m128i blockFirst = _mm_or_si128(_mm_loadu_si128((const __m128i*)(haystack + i)), fold);
+        __m128i blockLast = _mm_or_si128(_mm_loadu_si128((const __m128i*)(haystack + i + needleLength - 1)), fold);
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last)));
+        
+        while (mask != 0) {
+            int bit = __builtin_ctz(mask);
+            if (equalsIgnoreCase(haystack + i + bit, needle, needleLength)) {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    
+    size_t positions = haystackLength - needleLength + 1;
+    if (i >= positions) {
+        return NULL;
+    }
+    if (haystackLength < needleLength - 1 + 16) {
+        return findIgnoreCaseScalar(haystack + i, haystackLength - i, needle, needleLength);
+    }
+    
+    // One last block ending exactly at the end, skipping positions already checked
+    size_t start = positions - 16;
+    __m128i blockFirst = _mm_or_si128(_mm_loadu_si128((const __m128i*)(haystack + start)), fold);
+    __m128i blockLast = _mm_or_si128(_mm_loadu_si128((const __m128i*)(haystack + start + needleLength - 1)), fold);
+    unsigned int mask = (unsigned int)_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last)));
+    mask &= ~((1u << (i - start)) - 1);
+    
+    while (mask != 0) {
+        int bit = __builtin_ctz(mask);
+        if (equalsIgnoreCase(haystack + start + bit, needle, needleLength)) {
+            return haystack + start + bit;
+        }
+        mask &= mask - 1;
+    }
+    return NULL;
+}
+
+// Same filter as the SSE2 kernel over 32 positions per step
+__attribute__((target("avx2")))
+const char* findIgnoreCaseAvx2(const char *haystack, size_t haystackLength, const char *needle, size_t needleLength) {
+    if (needleLength > haystackLength) {
+        return NULL;
+    }
+    
+    // Too short for one 32-byte block: hand over before touching any ymm
+    // register, so there is no AVX/SSE state transition on the way
+    if (haystackLength < needleLength - 1 + 32) {
+        return findIgnoreCaseSse2(haystack, haystackLength, needle, needleLength);
+    }
+    
+    const __m256i fold = _mm256_set1_epi8(0x20);
+    const __m256i first = _mm256_set1_epi8((char)(needle[0] | 0x20));
+    const __m256i last = _mm256_set1_epi8((char)(needle[needleLength - 1] | 0x20));
+    
+    size_t i = 0;
+    for (; i + needleLength - 1 + 32 <= haystackLength; i += 32) {
+        __m256i blockFirst = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(haystack + i)), fold);
+        __m256i blockLast = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(haystack + i + needleLength - 1)), fold);
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last)));
+        
+        while (mask != 0) {
+            int bit = __builtin_ctz(mask);
+            if (equalsIgnoreCase(haystack + i + bit, needle, needleLength)) {
+                return haystack + i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    
+    size_t positions = haystackLength - needleLength + 1;
+    if (i >= positions) {
+        return NULL;
+    }
+    
+    // One last block ending exactly at the end, skipping positions already checked
+    size_t start = positions - 32;
+    __m256i blockFirst = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(haystack + start)), fold);
+    __m256i blockLast = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(haystack + start + needleLength - 1)), fold);
+    unsigned int mask = (unsigned int)_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last)));
+    mask &= ~((1u << (i - start)) - 1);
+    
+    while (mask != 0) {
+        int bit = __builtin_ctz(mask);
+        if (equalsIgnoreCase(haystack + start + bit, needle, needleLength)) {
+            return haystack + start + bit;
+        }
+        mask &= mask - 1;
+    }
+    return NULL;
+}
+#endif
+
+// Pick the widest kernel this CPU runs
+void selectSubstringKernel() {
+    substringKernel = findIgnoreCaseScalar;
+    substringKernelName = "scalar";
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        substringKernel = findIgnoreCaseAvx2;
+        substringKernelName = "AVX2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        substringKernel = findIgnoreCaseSse2;
+        substringKernelName = "SSE2";
+    }
+#endif
+}
+
+// Case-insensitive substring test
+bool containsIgnoreCase(const char *haystack, const char *needle) {
+    size_t needleLength = strlen(needle);
+    if (needleLength == 0) {
+        return true;
+    }
+    
+    if (substringKernel == NULL) {
+        selectSubstringKernel();
+    }
+    return substringKernel(haystack, strlen(haystack), needle, needleLength) != NULL;
+}
+
+// Split a query into terms in place: words, or "quoted phrases" kept whole.
+// The caller frees *terms (the strings point into query).
+int splitSearchTerms(char *query, char ***terms) {
+    int capacity = 8;
+    int count = 0;
+    *terms = (char**)malloc((size_t)capacity * sizeof(char*));
+    if (*terms == NULL) {
+        return 0;
+    }
+    
+    char *p = query;
+    while (*p != '\0') {
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0') break;
+        
+        char *start;
+        if (*p == '"') {
+            start = ++p;
+            while (*p != '\0' && *p != '"') p++;
+        } else {
+            start = p;
+            while (*p != '\0' && !isspace((unsigned char)*p)) p++;
+        }
+        if (*p != '\0') {
+            *p++ = '\0';
+        }
+        if (*start == '\0') {
+            continue;
+        }
+        
+        if (count == capacity) {
+            char **grown = (char**)realloc(*terms, (size_t)capacity * 2 * sizeof(char*));
+            if (grown == NULL) break;
+            *terms = grown;
+            capacity *= 2;
+        }
+        (*terms)[count++] = start;
+    }
+    return count;
+}
+
+// Slots (in list order) of tasks whose description contains every term of
+// the query, ignoring case. Terms of three or more characters are answered
+// from the trigram index; shorter ones are checked on the candidates only,
+// and a query made only of short terms falls back to a scan.
+int* searchDescriptions(const char *query, int *count) {
+    ensureIndexes();
+    if (trigramIndexStale) {
+        rebuildTrigramIndex();
+    }
+    *count = 0;
+    char *buffer = (char*)malloc(strlen(query) + 1);
+    if (buffer == NULL) {
+        printf("Memory allocation error\n");
+        return NULL;
+    }
+    strcpy(buffer, query);
+    
+    char **terms;
+    int termCount = splitSearchTerms(buffer, &terms);
+    
+    int *candidates = NULL;
+    int candidateCount = 0;
+    bool indexed = false;
+    for (int t = 0; t < termCount; t++) {
+        if (strlen(terms[t]) < 3) {
+            continue;
+        }
+        
+        int n;
+        int *ids = termCandidates(terms[t], &n);
+        if (ids == NULL) {
+            free(candidates);
+            free(terms);
+            free(buffer);
+            printf("Memory allocation error\n");
+            return NULL;
+        }
+        if (!indexed) {
+            candidates = ids;
+            candidateCount = n;
+            indexed = true;
+        } else {
+            candidateCount = intersectIds(candidates, candidateCount, ids, n, candidates);
+            free(ids);
+        }
+    }
+    
+    int *slots = (int*)malloc((size_t)((indexed ? candidateCount : taskCount) + 1) * sizeof(int));
+    if (slots == NULL) {
+        free(candidates);
+        free(terms);
+        free(buffer);
+        printf("Memory allocation error\n");
+        return NULL;
+    }
+    
+    int n = 0;
+    int scanCount = indexed ? candidateCount : taskSlotCount;
+    for (int c = 0; c < scanCount; c++) {
+        int slot = indexed ? findTaskIndex(candidates[c]) : c;
+        if (slot < 0 || taskIds[slot] == 0) {
+            continue;
+        }
+        
+        // Candidates only share trigrams with the terms; confirm the substrings
+        bool match = true;
+        for (int t = 0; t < termCount && match; t++) {
+            match = containsIgnoreCase(taskDescription(slot), terms[t]);
+        }
+        if (match) {
+            slots[n++] = slot;
+        }
+    }
+    
+    if (indexed) {
+        qsort(slots, n, sizeof(int), compareInts);
+    }
+    
+    free(candidates);
+    free(terms);
+    free(buffer);
+    *count = n;
+    return slots;
+}
+
+// Human-readable byte count
+void formatBytes(size_t bytes, char *buffer, size_t size) {
+    if (bytes >= (size_t)1 << 30) {
+        snprintf(buffer, size, "%.2f GiB", bytes / (double)((size_t)1 << 30));
+    } else if (bytes >= (size_t)1 << 20) {
+        snprintf(buffer, size, "%.2f MiB", bytes / (double)((size_t)1 << 20));
+    } else if (bytes >= (size_t)1 << 10) {
+        snprintf(buffer, size, "%.2f KiB", bytes / (double)((size_t)1 << 10));
+    } else {
+        snprintf(buffer, size, "%zu B", bytes);
+    }
+}
+
+// Print how much memory the task store uses, plus a sizing estimate for large task sets
+void showStorageReport() {
+    size_t hotBytesPerTask = sizeof(int) + sizeof(Priority) + sizeof(int) + sizeof(time_t) + sizeof(bool);
+    size_t slotBytes = hotBytesPerTask + sizeof(unsigned int);
+    size_t internBytes = (size_t)internTableCapacity * sizeof(InternEntry);
+    double textPerTask = taskCount > 0 ? (double)(descriptionArenaUsed - descriptionArenaStale) / taskCount : 0.0;
+    double bytesPerTask = slotBytes + textPerTask;
+    size_t usedBytes = (size_t)taskSlotCount * slotBytes + descriptionArenaUsed;
+    size_t reservedBytes = (size_t)taskCapacity * slotBytes + descriptionArenaCapacity;
+    size_t perMillion = (size_t)(1000000 * bytesPerTask);
+    size_t indexBytes = (size_t)idIndexCapacity * 2 * sizeof(int) +
+                        (size_t)taskCapacity * 2 * sizeof(int) +
+                        (size_t)pendingSet.capacity * sizeof(int) +
+                        (size_t)createdIndexCapacity * sizeof(CreatedEntry) +
+                        internBytes;
+    for (int b = 0; b < 3; b++) {
+        indexBytes += (size_t)priorityBuckets[b].capacity * sizeof(int);
+    }
+    char used[32], reserved[32], slack[32], million[32], millionPeak[32], indexes[32], arena[32], stale[32];
+    
+    formatBytes(usedBytes, used, sizeof(used));
+    formatBytes(reservedBytes, reserved, sizeof(reserved));
+    formatBytes(reservedBytes - usedBytes, slack, sizeof(slack));
+    formatBytes(perMillion, million, sizeof(million));
+    formatBytes(perMillion + perMillion / 2, millionPeak, sizeof(millionPeak));
+    formatBytes(indexBytes, indexes, sizeof(indexes));
+    formatBytes(descriptionArenaUsed, arena, sizeof(arena));
+    formatBytes(descriptionArenaStale, stale, sizeof(stale));
+    
+    printf("\n=== Storage Report ===\n");
+    printf("Tasks stored:        %d\n", taskCount);
+    printf("Slots in use:        %d (%d free for reuse)\n", taskSlotCount, freeSlotCount);
+    printf("Slots allocated:     %d\n", taskCapacity);
+    printf("Bytes per task:      %.1f (%zu in hot columns, %zu offset, %.1f description text)\n",
+           bytesPerTask, hotBytesPerTask, sizeof(unsigned int), textPerTask);
+    printf("                     (a fixed %d-byte description column would make it %zu)\n",
+           MAX_DESCRIPTION, hotBytesPerTask + MAX_DESCRIPTION);
+    printf("Description arena:   %s, %d distinct strings, %s stale\n", arena, internTableCount, stale);
+    printf("Memory in use:       %s\n", used);
+    printf("Memory reserved:     %s\n", reserved);
+    printf("Growth headroom:     %s (%.1f%%)\n", slack,
+           taskCapacity > 0 ? 100.0 * (taskCapacity - taskSlotCount) / taskCapacity : 0.0);
+    printf("Index memory:        %s\n", indexes);
+    char edges[32];
+    formatBytes((size_t)dependencyCapacity * sizeof(DependencyEdge), edges, sizeof(edges));
+    printf("Dependencies:        %d (%s)\n", dependencyCount, edges);
+    printf("Sizing per 1M tasks: %s (up to %s while growing, before indexes)\n", million, millionPeak);
+}
+
+// Build the CRC32C table and pick the kernel; run once through crc32cOnce
+void selectCrc32cKernel() {
+    for (unsigned int i = 0; i < 256; i++) {
+        unsigned int c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+        }
+        crc32cTable[i] = c;
+    }
+    
+    crc32cKernel = crc32cSoftware;
+    crc32cKernelName = "table";
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc32cKernel = crc32cSse42;
+        crc32cKernelName = "SSE4.2";
+    }
+#endif
+}
+
+// CRC32C (Castagnoli), table driven; the table comes from selectCrc32cKernel
+unsigned int crc32cSoftware(unsigned int crc, const void *data, size_t length) {
+    const unsigned char *p = (const unsigned char*)data;
+    crc = ~crc;
+    while (length-- > 0) {
+        crc = crc32cTable[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#ifdef HAVE_X86_SIMD
+// CRC32C with the SSE4.2 crc32 instruction, 8 bytes at a time on x86-64
+__attribute__((target("sse4.2")))
+unsigned int crc32cSse42(unsigned int crc, const void *data, size_t length) {
+    const unsigned char *p = (const unsigned char*)data;
+    crc = ~crc;
+#ifdef __x86_64__
+    unsigned long long wide = crc;
+    while (length >= 8) {
+        unsigned long long word;
+        memcpy(&word, p, 8);
+        wide = _mm_crc32_u64(wide, word);
+        p += 8;
+        length -= 8;
+    }
+    crc = (unsigned int)wide;
+#endif
+    while (length >= 4) {
+        unsigned int word;
+        memcpy(&word, p, 4);
+        crc = _mm_crc32_u32(crc, word);
+        p += 4;
+        length -= 4;
+    }
+    while (length-- > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return ~crc;
+}
+#endif
+
+unsigned int crc32c(unsigned int crc, const void *data, size_t length) {
+    pthread_once(&crc32cOnce, selectCrc32cKernel);
+    return crc32cKernel(crc, data, length);
+}
+
+// Flush a stream all the way to the disk
+bool syncFile(FILE *file) {
+    if (fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Flush the directory holding `path`, making a rename or create in it durable
+bool syncParentDirectory(const char *path) {
+#ifdef _WIN32
+    (void)path;
+    return true;   // MOVEFILE_WRITE_THROUGH already waits for the rename
+#else
+    char directory[PATH_MAX];
+    const char *slash = strrchr(path, '/');
+    if (slash == NULL) {
+        strcpy(directory, ".");
+    } else if (slash == path) {
+        strcpy(directory, "/");
+    } else if ((size_t)(slash - path) < sizeof(directory)) {
+        memcpy(directory, path, (size_t)(slash - path));
+        directory[slash - path] = '\0';
+    } else {
+        return false;
+    }
+    
+    int fd = open(directory, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#endif
+}
+
+// Atomically and durably put `from` in place of `to`. Until the directory
+// is flushed a crash may still bring back the old `to`.
+bool replaceFile(const char *from, const char *to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0 && syncParentDirectory(to);
+#endif
+}
+
+// Write a versioned snapshot, synced to disk:
+//   header: "TMGR", u16 version, u16 reserved, u32 nextTaskId, u32 task count,
+//           u32 tasks per block, u32 CRC32C of the preceding 20 bytes
+//   blocks: u32 tasks, u32 payload bytes, u32 CRC32C of payload, payload
+//   dependencies (version 2): u32 edges, u32 payload bytes, u32 CRC32C of
+//           payload, then per edge the varint task ID as a delta from the
+//           previous edge's and the varint prerequisite ID
+// All integers are little-endian; tasks are encoded by encodeTaskRecord().
+bool writeSnapshot(const char *path) {
+    unsigned char *block = (unsigned char*)malloc((size_t)SNAPSHOT_BLOCK_TASKS * TASK_RECORD_MAX);
+    if (block == NULL) {
+        printf("Memory allocation error\n");
+        return false;
+    }
+    
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("Error: Cannot open file for writing.\n");
+        free(block);
+        return false;
+    }
+    
+    unsigned char header[SNAPSHOT_HEADER_SIZE];
+    memcpy(header, SNAPSHOT_MAGIC, 4);
+    header[4] = SNAPSHOT_VERSION & 0xFF;
+    header[5] = SNAPSHOT_VERSION >> 8;
+    header[6] = 0;
+    header[7] = 0;
+    putUint32(header + 8, (unsigned int)nextTaskId);
+    putUint32(header + 12, (unsigned int)taskCount);
+    putUint32(header + 16, SNAPSHOT_BLOCK_TASKS);
+    putUint32(header + 20, crc32c(0, header, SNAPSHOT_HEADER_SIZE - 4));
+    fwrite(header, 1, sizeof(header), file);
+    
+    size_t blockBytes = 0;
+    int blockTasks = 0;
+    long long previousCreated = 0;
+    for (int i = 0; i <= taskSlotCount; i++) {
+        if (i < taskSlotCount && taskIds[i] != 0) {
+            blockBytes += encodeTaskRecord(block + blockBytes, i, &previousCreated);
+            blockTasks++;
+        }
+        
+        if (blockTasks == SNAPSHOT_BLOCK_TASKS || (i == taskSlotCount && blockTasks > 0)) {
+            unsigned char blockHeader[SNAPSHOT_BLOCK_HEADER_SIZE];
+            putUint32(blockHeader, (unsigned int)blockTasks);
+            putUint32(blockHeader + 4, (unsigned int)blockBytes);
+            putUint32(blockHeader + 8, crc32c(0, block, blockBytes));
+            fwrite(blockHeader, 1, sizeof(blockHeader), file);
+            fwrite(block, 1, blockBytes, file);
+            blockBytes = 0;
+            blockTasks = 0;
+            previousCreated = 0;
+        }
+    }
+    free(block);
+    
+    // Edges are in task order; those to deleted tasks are dropped here
+    ensureDependenciesSorted();
+    unsigned char *edges = (unsigned char*)malloc((size_t)dependencyCount * 10 + 1);
+    if (edges == NULL) {
+        printf("Memory allocation error\n");
+        fclose(file);
+        return false;
+    }
+    size_t edgeBytes = 0;
+    unsigned int edgeCount = 0;
+    int previousTask = 0;
+    for (int i = 0; i < dependencyCount; i++) {
+        const DependencyEdge *e = &dependencies[i];
+        if (findTaskIndex(e->task) < 0 || findTaskIndex(e->prerequisite) < 0) {
+            continue;
+        }
+        edgeBytes += putVarint(edges + edgeBytes, (unsigned int)(e->task - previousTask));
+        edgeBytes += putVarint(edges + edgeBytes, (unsigned int)e->prerequisite);
+        previousTask = e->task;
+        edgeCount++;
+    }
+    unsigned char sectionHeader[SNAPSHOT_BLOCK_HEADER_SIZE];
+    putUint32(sectionHeader, edgeCount);
+    putUint32(sectionHeader + 4, (unsigned int)edgeBytes);
+    putUint32(sectionHeader + 8, crc32c(0, edges, edgeBytes));
+    fwrite(sectionHeader, 1, sizeof(sectionHeader), file);
+    fwrite(edges, 1, edgeBytes, file);
+    free(edges);
+    
+    bool written = !ferror(file) && syncFile(file);
+    fclose(file);
+    return written;
+}
+
+// Save a full snapshot of the tasks and start a new, empty journal. The
+// snapshot is written to a temporary file and renamed over tasks.dat, so a
+// crash at any point leaves either the old or the new snapshot in place.
+// The journal is only emptied once the rename itself is durable; otherwise
+// a crash could bring back the old snapshot beside an empty journal.
+void saveTasksToFile() {
+    bool written = writeSnapshot(SNAPSHOT_TEMP_FILENAME);
+    
+    if (!written || !replaceFile(SNAPSHOT_TEMP_FILENAME, FILENAME)) {
+        printf("Error: Cannot write %s.\n", FILENAME);
+        remove(SNAPSHOT_TEMP_FILENAME);
+        return;
+    }
+    
+    // Everything in the journal is now in the snapshot
+    if (journalFile != NULL) {
+        fclose(journalFile);
+    }
+    journalFile = fopen(JOURNAL_FILENAME, "wb");
+    if (journalFile != NULL) {
+        syncFile(journalFile);
+        syncParentDirectory(JOURNAL_FILENAME);
+    }
+    journalRecords = 0;
+    
+    printf("Tasks saved to %s\n", FILENAME);
+}
+
+// Append one record to the journal; call journalSync() to make it durable
+bool journalAppend(JournalRecordType type, const void *payload, unsigned int length) {
+    if (journalFile == NULL) {
+        journalFile = fopen(JOURNAL_FILENAME, "ab");
+        if (journalFile == NULL) {
+            printf("Error: Cannot open %s for writing.\n", JOURNAL_FILENAME);
+            return false;
+        }
+        // The journal may have just been created; its records are only
+        // durable once its directory entry is
+        syncParentDirectory(JOURNAL_FILENAME);
+    }
+    
+    unsigned char header[JOURNAL_HEADER_SIZE];
+    putUint32(header, (unsigned int)type);
+    putUint32(header + 4, length);
+    putUint32(header + 8, crc32c(crc32c(0, header, 8), payload, length));
+    
+    if (fwrite(header, 1, sizeof(header), journalFile) != sizeof(header) ||
+        fwrite(payload, 1, length, journalFile) != length) {
+        printf("Error: Cannot write to %s.\n", JOURNAL_FILENAME);
+        return false;
+    }
+    journalRecords++;
+    return true;
+}
+
+bool journalSync() {
+    if (journalFile == NULL || !syncFile(journalFile)) {
+        printf("Error: Cannot flush %s.\n", JOURNAL_FILENAME);
+        return false;
+    }
+    return true;
+}
+
+// Log a task's full contents (add or update) and make it durable
+void journalTask(JournalRecordType type, int slot) {
+    if (journalTaskRecord(type, slot)) {
+        journalSync();
+    }
+    checkpointIfNeeded();
+}
+
+// Log a task's full contents without syncing, for batches that flush once
+bool journalTaskRecord(JournalRecordType type, int slot) {
+    unsigned char payload[TASK_RECORD_MAX];
+    long long previousCreated = 0;
+    size_t length = encodeTaskRecord(payload, slot, &previousCreated);
+    return journalAppend(type, payload, (unsigned int)length);
+}
+
+void journalDelete(int id) {
+    unsigned char payload[4];
+    putUint32(payload, (unsigned int)id);
+    if (journalAppend(JOURNAL_DELETE, payload, sizeof(payload))) {
+        journalSync();
+    }
+    checkpointIfNeeded();
+}
+
+// Log a task's completion state; the caller syncs, so a batch costs one flush
+void journalCompletion(int slot) {
+    journalCompletionRecord(taskIds[slot], taskCompleted[slot]);
+}
+
+// Completion record from a task's ID alone, for writers that must not read the task store
+bool journalCompletionRecord(int id, bool completed) {
+    unsigned char payload[8];
+    putUint32(payload, (unsigned int)id);
+    putUint32(payload + 4, completed ? 1 : 0);
+    return journalAppend(JOURNAL_COMPLETE, payload, sizeof(payload));
+}
+
+// Log a dependency being added (present) or removed, and make it durable
+void journalDependency(int task, int prerequisite, bool present) {
+    unsigned char payload[12];
+    putUint32(payload, (unsigned int)task);
+    putUint32(payload + 4, (unsigned int)prerequisite);
+    putUint32(payload + 8, present ? 1 : 0);
+    if (journalAppend(JOURNAL_DEPENDENCY, payload, sizeof(payload))) {
+        journalSync();
+    }
+    checkpointIfNeeded();
+}
+
+// Fold the journal into a new snapshot once it has as many records as there
+// are tasks; each snapshot is paid for by the O(1) appends before it
+void checkpointIfNeeded() {
+    if (journalRecords >= JOURNAL_CHECKPOINT_MIN && journalRecords >= taskCount) {
+        saveTasksToFile();
+    }
+}
+
+// Make a batch of unsynced records durable with one flush: a fresh snapshot
+// when the batch has grown the journal past a checkpoint, else one fsync
+void flushJournalBatch() {
+    if (journalFile == NULL) {
+        return;   // nothing written since the load
+    }
+    if (journalRecords >= JOURNAL_CHECKPOINT_MIN && journalRecords >= taskCount) {
+        saveTasksToFile();
+    } else {
+        journalSync();
+    }
+}
+
+// Overwrite the task in a slot, keeping every index in step
+void replaceTaskAt(int slot, const Task *t) {
+    ensureIndexes();
+    unindexTaskSlot(slot);
+    duplicateIndexRemove(slot);
+    trigramIndexReplace(t->id, taskDescription(slot), t->description);
+    releaseDescription(taskDescriptionOffsets[slot]);
+    
+    storeTaskAt(slot, t);
+    indexTaskSlot(slot);
+    duplicateIndexAdd(slot);
+    compactDescriptionsIfNeeded();
+}
+
+void applyJournalRecord(JournalRecordType type, const void *payload, unsigned int length) {
+    switch (type) {
+        case JOURNAL_ADD:
+        case JOURNAL_UPDATE: {
+            Task t;
+            const unsigned char *p = (const unsigned char*)payload;
+            long long previousCreated = 0;
+            if (!decodeTaskRecord(&p, p + length, &t, &previousCreated)) return;
+            
+            int slot = findTaskIndex(t.id);
+            if (slot >= 0) {
+                replaceTaskAt(slot, &t);
+            } else if (type == JOURNAL_ADD) {
+                appendTask(&t);
+            }
+            if (t.id >= nextTaskId) {
+                nextTaskId = t.id + 1;
+            }
+            break;
+        }
+        case JOURNAL_DELETE: {
+            if (length != 4) return;
+            int slot = findTaskIndex((int)getUint32((const unsigned char*)payload));
+            if (slot >= 0) {
+                removeTaskAt(slot);
+            }
+            break;
+        }
+        case JOURNAL_COMPLETE: {
+            if (length != 8) return;
+            const unsigned char *p = (const unsigned char*)payload;
+            int slot = findTaskIndex((int)getUint32(p));
+            if (slot >= 0) {
+                setTaskCompleted(slot, getUint32(p + 4) != 0);
+            }
+            break;
+        }
+        case JOURNAL_DEPENDENCY: {
+            if (length != 12) return;
+            const unsigned char *p = (const unsigned char*)payload;
+            int task = (int)getUint32(p);
+            int prerequisite = (int)getUint32(p + 4);
+            if (getUint32(p + 8) != 0) {
+                appendDependency(task, prerequisite);
+            } else {
+                removeDependency(task, prerequisite);
+            }
+            break;
+        }
+    }
+}
+
+// Re-apply the journal on top of the snapshot. Replay stops at the first
+// record that is short or fails its checksum (a write torn by a crash);
+// the result is then checkpointed so the journal starts clean again.
+int replayJournal() {
+    FILE *file = fopen(JOURNAL_FILENAME, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+    
+    int replayed = 0;
+    bool torn = false;
+    unsigned char *payload = NULL;
+    unsigned int payloadCapacity = 0;
+    unsigned char header[JOURNAL_HEADER_SIZE];
+    
+    size_t headerBytes;
+    while ((headerBytes = fread(header, 1, sizeof(header), file)) == sizeof(header)) {
+        unsigned int type = getUint32(header);
+        unsigned int length = getUint32(header + 4);
+        if (length > (1u << 20)) {
+            torn = true;
+            break;
+        }
+        if (length > payloadCapacity) {
+            unsigned char *grown = (unsigned char*)realloc(payload, length);
+            if (grown == NULL) {
+                torn = true;
+                break;
+            }
+            payload = grown;
+            payloadCapacity = length;
+        }
+        
+        if (fread(payload, 1, length, file) != length ||
+            crc32c(crc32c(0, header, 8), payload, length) != getUint32(header + 8)) {
+            torn = true;
+            break;
+        }
+        
+        applyJournalRecord((JournalRecordType)type, payload, length);
+        replayed++;
+    }
+    if (!torn && (headerBytes != 0 || !feof(file))) {
+        torn = true;
+    }
+    
+    free(payload);
+    fclose(file);
+    
+    journalRecords = replayed;
+    if (torn) {
+        printf("Warning: %s ends in an incomplete record; it was ignored.\n", JOURNAL_FILENAME);
+        saveTasksToFile();
+    }
+    return replayed;
+}
+
+// Load the snapshot in tasks.dat, then replay the journal on top of it
+void loadTasksFromFile() {
+    if (loadSnapshot(FILENAME, MMAP_STORAGE) < 0) {
+        printf("No saved tasks found. Starting with empty task list.\n");
+    } else {
+        printf("Loaded %d tasks from %s\n", taskCount, FILENAME);
+    }
+    
+    int replayed = replayJournal();
+    if (replayed > 0) {
+        printf("Replayed %d change(s) from %s\n", replayed, JOURNAL_FILENAME);
+    }
+}
+
+// Convert priority enum to string
+const char* priorityToString(Priority p) {
+    switch (p) {
+        case HIGH: return "High";
+        case MEDIUM: return "Medium";
+        case LOW: return "Low";
+        default: return "Unknown";
+    }
+}
+
+// Function to check if a task with similar description and properties already exists
+bool isDuplicateTask(const char* description, Priority priority, int duration) {
+    int i = findDuplicateTask(description, priority, duration);
+    if (i >= 0) {
+        printf("\n⚠️ Similar task already exists! ⚠️\n");
+        displayTaskDetails(taskAt(i));
+        printf("Do you still want to add this task? (1=Yes, 0=No): ");
+        int confirm;
+        scanf("%d", &confirm);
+        return confirm != 1;
+    }
+    return false;
+}
+
+// Next character of a description as compared for duplicates: case folded,
+// leading/trailing whitespace dropped and inner whitespace runs read as one
+// space. Returns 0 at the end.
+int nextNormalizedChar(const char **cursor, bool *started) {
+    const char *p = *cursor;
+    if (isspace((unsigned char)*p)) {
+        while (isspace((unsigned char)*p)) p++;
+        if (*p != '\0' && *started) {
+            *cursor = p;
+            return ' ';
+        }
+    }
+    if (*p == '\0') {
+        *cursor = p;
+        return 0;
+    }
+    
+    *started = true;
+    *cursor = p + 1;
+    return foldCase((unsigned char)*p);
+}
+
+// 64-bit FNV-1a over the normalized description (and schedule, if configured)
+unsigned long long duplicateKey(const char *description, Priority priority, int duration) {
+    unsigned long long hash = 14695981039346656037ull;
+    bool started = false;
+    int c;
+    while ((c = nextNormalizedChar(&description, &started)) != 0) {
+        hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+    }
+#if DUPLICATE_KEY_INCLUDES_SCHEDULE
+    hash = (hash ^ (unsigned int)priority) * 1099511628211ull;
+    hash = (hash ^ (unsigned int)duration) * 1099511628211ull;
+#else
+    (void)priority;
+    (void)duration;
+#endif
+    return hash;
+}
+
+// Confirm a hash hit: do the task and the new values really share a key?
+bool sameDuplicateKey(int slot, const char *description, Priority priority, int duration) {
+#if DUPLICATE_KEY_INCLUDES_SCHEDULE
+    if (taskPriorities[slot] != priority || taskDurations[slot] != duration) {
+        return false;
+    }
+#else
+    (void)priority;
+    (void)duration;
+#endif
+    const char *a = taskDescription(slot);
+    const char *b = description;
+    bool startedA = false, startedB = false;
+    int ca, cb;
+    do {
+        ca = nextNormalizedChar(&a, &startedA);
+        cb = nextNormalizedChar(&b, &startedB);
+        if (ca != cb) {
+            return false;
+        }
+    } while (ca != 0);
+    return true;
+}
+
+// Keep the duplicate table at most half full
+bool reserveDuplicateIndex(int needed) {
+    if (needed * 2 <= duplicateTableCapacity) {
+        return true;
+    }
+    
+    int newCapacity = duplicateTableCapacity > 0 ? duplicateTableCapacity : INITIAL_INDEX_CAPACITY;
+    while (newCapacity < needed * 2) {
+        if (newCapacity > INT_MAX / 2) {
+            return false;
+        }
+        newCapacity *= 2;
+    }
+    
+    DuplicateEntry *newTable = (DuplicateEntry*)calloc(newCapacity, sizeof(DuplicateEntry));
+    if (newTable == NULL) {
+        printf("Error: Out of memory growing duplicate index.\n");
+        return false;
+    }
+    
+    DuplicateEntry *oldTable = duplicateTable;
+    int oldCapacity = duplicateTableCapacity;
+    duplicateTable = newTable;
+    duplicateTableCapacity = newCapacity;
+    duplicateTableCount = 0;
+    
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldTable[i].id != 0) {
+            duplicateIndexInsert(oldTable[i].hash, oldTable[i].id);
+        }
+    }
+    free(oldTable);
+    return true;
+}
+
+// Equal hashes may repeat (duplicates are allowed after confirmation), so
+// every insert takes a new entry
+void duplicateIndexInsert(unsigned long long hash, int id) {
+    unsigned int mask = (unsigned int)duplicateTableCapacity - 1;
+    unsigned int i = (unsigned int)(hash ^ (hash >> 32)) & mask;
+    while (duplicateTable[i].id != 0) {
+        i = (i + 1) & mask;
+    }
+    duplicateTable[i].hash = hash;
+    duplicateTable[i].id = id;
+    duplicateTableCount++;
+}
+
+void duplicateIndexAdd(int slot) {
+    if (!duplicateIndexStale && reserveDuplicateIndex(duplicateTableCount + 1)) {
+        duplicateIndexInsert(duplicateKey(taskDescription(slot), taskPriorities[slot], taskDurations[slot]),
+                             taskIds[slot]);
+    }
+}
+
+// Remove a task's entry, shifting later entries of the probe chain back into the gap
+void duplicateIndexRemove(int slot) {
+    if (duplicateIndexStale || duplicateTableCapacity == 0) {
+        return;
+    }
+    
+    unsigned long long hash = duplicateKey(taskDescription(slot), taskPriorities[slot], taskDurations[slot]);
+    int id = taskIds[slot];
+    unsigned int mask = (unsigned int)duplicateTableCapacity - 1;
+    unsigned int i = (unsigned int)(hash ^ (hash >> 32)) & mask;
+    
+    while (duplicateTable[i].id != id) {
+        if (duplicateTable[i].id == 0) {
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    
+    unsigned int gap = i;
+    for (unsigned int j = (gap + 1) & mask; duplicateTable[j].id != 0; j = (j + 1) & mask) {
+        unsigned long long h = duplicateTable[j].hash;
+        unsigned int home = (unsigned int)(h ^ (h >> 32)) & mask;
+        if (((j - home) & mask) >= ((j - gap) & mask)) {
+            duplicateTable[gap] = duplicateTable[j];
+            gap = j;
+        }
+    }
+    
+    duplicateTable[gap].id = 0;
+    duplicateTableCount--;
+}
+
+void rebuildDuplicateIndex() {
+    if (duplicateTableCapacity > 0) {
+        memset(duplicateTable, 0, (size_t)duplicateTableCapacity * sizeof(DuplicateEntry));
+    }
+    duplicateTableCount = 0;
+    duplicateIndexStale = false;
+    
+    if (!reserveDuplicateIndex(taskCount)) {
+        return;
+    }
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] != 0) {
+            duplicateIndexInsert(duplicateKey(taskDescription(i), taskPriorities[i], taskDurations[i]),
+                                 taskIds[i]);
+        }
+    }
+}
+
+// Slot of an existing task with the same duplicate key, or -1
+int findDuplicateTask(const char *description, Priority priority, int duration) {
+    if (duplicateIndexStale) {
+        rebuildDuplicateIndex();
+    }
+    if (duplicateTableCapacity == 0) {
+        return -1;
+    }
+    
+    unsigned long long hash = duplicateKey(description, priority, duration);
+    unsigned int mask = (unsigned int)duplicateTableCapacity - 1;
+    unsigned int i = (unsigned int)(hash ^ (hash >> 32)) & mask;
+    
+    for (; duplicateTable[i].id != 0; i = (i + 1) & mask) {
+        if (duplicateTable[i].hash == hash) {
+            int slot = findTaskIndex(duplicateTable[i].id);
+            if (slot >= 0 && sameDuplicateKey(slot, description, priority, duration)) {
+                return slot;
+            }
+        }
+    }
+    return -1;
+}
+
+// Function to display a single task with details
+void displayTaskDetails(Task task) {
+    char timeStr[30];
+    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&task.created));
+    
+    printf("┌──────────────────────────────────────────────────────────────┐\n");
+    printf("│ Task ID: %-52d │\n", task.id);
+    printf("├──────────────────────────────────────────────────────────────┤\n");
+    printf("│ Description: %-48s │\n", task.description);
+    printf("│ Priority:    %-48s │\n", priorityToString(task.priority));
+    printf("│ Duration:    %-2d seconds                                      │\n", task.duration);
+    printf("│ Created:     %-48s │\n", timeStr);
+    printf("│ Status:      %-48s │\n", task.completed ? "Completed" : "Pending");
+    char prerequisites[49];
+    if (formatPrerequisites(task.id, false, prerequisites, sizeof(prerequisites)) > 0) {
+        printf("│ Depends on:  %-48s │\n", prerequisites);
+    }
+    printf("└──────────────────────────────────────────────────────────────┘\n");
+}
+
+// Hand out the next task ID, or 0 once every ID below INT_MAX has been used
+int claimTaskId() {
+    if (nextTaskId >= INT_MAX) {
+        printf("Error: Task IDs are exhausted.\n");
+        return 0;
+    }
+    return nextTaskId++;
+}
+
+// Function to add a new task
+void addTask() {
+    Task t;
+    t.id = claimTaskId();
+    if (t.id == 0) {
+        return;
+    }
+    t.created = time(NULL);
+    t.completed = false;
+
+    printf("\n=== Adding New Task ===\n");
+    printf("Task ID: %d (auto-assigned)\n", t.id);
+    
+    clearInputBuffer();
+    printf("Enter description: ");
+    fgets(t.description, MAX_DESCRIPTION, stdin);
+    t.description[strcspn(t.description, "\n")] = 0;
+    
+    int priorityChoice;
+    do {
+        printf("Select priority:\n");
+        printf("1. High\n");
+        printf("2. Medium\n");
+        printf("3. Low\n");
+        printf("Choice: ");
+        scanf("%d", &priorityChoice);
+        
+        switch (priorityChoice) {
+            case 1: t.priority = HIGH; break;
+            case 2: t.priority = MEDIUM; break;
+            case 3: t.priority = LOW; break;
+            default: printf("Invalid choice. Try again.\n");
+        }
+    } while (priorityChoice < 1 || priorityChoice > 3);
+
+    do {
+        printf("Enter duration (in seconds, 1-3600): ");
+        scanf("%d", &t.duration);
+        
+        if (t.duration < 1 || t.duration > 3600) {
+            printf("Invalid duration. Please enter a value between 1 and 3600 seconds.\n");
+        }
+    } while (t.duration < 1 || t.duration > 3600);
+
+    // Check for duplicate tasks
+    if (isDuplicateTask(t.description, t.priority, t.duration)) {
+        return;
+    }
+
+    if (!appendTask(&t)) {
+        printf("Task could not be added.\n");
+        return;
+    }
+    printf("\nTask added successfully!\n");
+    
+    journalTask(JOURNAL_ADD, findTaskIndex(t.id));
+}
+
+// Function to display all tasks
+void viewTasks() {
+    if (taskCount == 0) {
+        printf("\nNo tasks available.\n");
+        return;
+    }
+
+    printf("\n=== Task List (%d tasks) ===\n", taskCount);
+    printf("┌─────┬───────────────────────────────┬──────────┬──────────┬──────────┐\n");
+    printf("│ ID  │ Description                   │ Priority │ Duration │ Status   │\n");
+    printf("├─────┼───────────────────────────────┼──────────┼──────────┼──────────┤\n");
+    
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] == 0) continue;
+        // Truncate description if too long for display
+        char shortDesc[30];
+        strncpy(shortDesc, taskDescription(i), 25);
+        shortDesc[25] = '\0';
+        if (strlen(taskDescription(i)) > 25) {
+            strcat(shortDesc, "...");
+        }
+        
+        printf("│ %-3d │ %-27s │ %-8s │ %-8d │ %-8s │\n", 
+               taskIds[i], 
+               shortDesc, 
+               priorityToString(taskPriorities[i]), 
+               taskDurations[i],
+               taskCompleted[i] ? "Done" : "Pending");
+    }
+    printf("└─────┴───────────────────────────────┴──────────┴──────────┴──────────┘\n");
+    
+    printf("\nEnter task ID for details or 0 to return: ");
+    int id;
+    scanf("%d", &id);
+    
+    if (id != 0) {
+        int i = findTaskIndex(id);
+        if (i >= 0) {
+            displayTaskDetails(taskAt(i));
+            return;
+        }
+        printf("Task not found.\n");
+    }
+}
+
+// Search for tasks
+void searchTasks() {
+    if (taskCount == 0) {
+        printf("\nNo tasks available to search.\n");
+        return;
+    }
+    
+    printf("\n=== Search Tasks ===\n");
+    printf("1. Search by keyword\n");
+    printf("2. Search by priority\n");
+    printf("3. Return to main menu\n");
+    printf("Choice: ");
+    
+    int choice;
+    scanf("%d", &choice);
+    
+    switch (choice) {
+        case 1: {
+            clearInputBuffer();
+            printf("Enter keywords (all must match, \"quote\" phrases): ");
+            char *keyword = readLine(stdin);
+            if (keyword == NULL) {
+                return;
+            }
+            
+            printf("\n=== Search Results ===\n");
+            int found = 0;
+            int *matches = searchDescriptions(keyword, &found);
+            if (matches == NULL) {
+                free(keyword);
+                return;
+            }
+            
+            for (int n = 0; n < found; n++) {
+                displayTaskDetails(taskAt(matches[n]));
+            }
+            free(matches);
+            
+            if (found == 0) {
+                printf("No tasks found matching '%s'\n", keyword);
+            } else {
+                printf("%d task(s) found.\n", found);
+            }
+            free(keyword);
+            break;
+        }
+        case 2: {
+            int priorityChoice;
+            printf("Select priority to search for:\n");
+            printf("1. High\n");
+            printf("2. Medium\n");
+            printf("3. Low\n");
+            printf("Choice: ");
+            scanf("%d", &priorityChoice);
+            
+            Priority searchPriority;
+            switch (priorityChoice) {
+                case 1: searchPriority = HIGH; break;
+                case 2: searchPriority = MEDIUM; break;
+                case 3: searchPriority = LOW; break;
+                default: printf("Invalid choice.\n"); return;
+            }
+            
+            printf("\n=== Search Results ===\n");
+            int found = 0;
+            int *matches = priorityTaskSlots(searchPriority, &found);
+            if (matches == NULL) {
+                return;
+            }
+            
+            for (int n = 0; n < found; n++) {
+                displayTaskDetails(taskAt(matches[n]));
+            }
+            free(matches);
+            
+            if (found == 0) {
+                printf("No tasks found with %s priority\n", priorityToString(searchPriority));
+            } else {
+                printf("%d task(s) found.\n", found);
+            }
+            break;
+        }
+        case 3:
+            return;
+        default:
+            printf("Invalid choice.\n");
+    }
+}
+
+// Delete a task
+void deleteTask() {
+    if (taskCount == 0) {
+        printf("\nNo tasks available to delete.\n");
+        return;
+    }
+    
+    printf("\n=== Delete Task ===\n");
+    
+    // Display a compact list of tasks
+    printf("Current tasks:\n");
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] == 0) continue;
+        printf("%d: %s (%s)\n", 
+               taskIds[i], 
+               taskDescription(i), 
+               priorityToString(taskPriorities[i]));
+    }
+    
+    printf("\nEnter task ID to delete (or 0 to cancel): ");
+    int id;
+    scanf("%d", &id);
+    
+    if (id == 0) return;
+    
+    // Find and delete the task
+    int i = findTaskIndex(id);
+    if (i < 0) {
+        printf("Task with ID %d not found.\n", id);
+        return;
+    }
+    
+    printf("Deleting task: %s\n", taskDescription(i));
+    printf("Are you sure? (1=Yes, 0=No): ");
+    int confirm;
+    scanf("%d", &confirm);
+    
+    if (confirm == 1) {
+        removeTaskAt(i);
+        printf("Task deleted successfully.\n");
+        journalDelete(id);
+    } else {
+        printf("Deletion cancelled.\n");
+    }
+}
+
+// Modify a task
+void modifyTask() {
+    if (taskCount == 0) {
+        printf("\nNo tasks available to modify.\n");
+        return;
+    }
+    
+    printf("\n=== Modify Task ===\n");
+    
+    // Display a compact list of tasks
+    printf("Current tasks:\n");
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] == 0) continue;
+        printf("%d: %s (%s)\n", 
+               taskIds[i], 
+               taskDescription(i), 
+               priorityToString(taskPriorities[i]));
+    }
+    
+    printf("\nEnter task ID to modify (or 0 to cancel): ");
+    int id;
+    scanf("%d", &id);
+    
+    if (id == 0) return;
+    
+    // Find the task
+    int i = findTaskIndex(id);
+    if (i < 0) {
+        printf("Task with ID %d not found.\n", id);
+        return;
+    }
+    
+    printf("\n=== Modifying Task ID: %d ===\n", taskIds[i]);
+    printf("1. Description: %s\n", taskDescription(i));
+    printf("2. Priority: %s\n", priorityToString(taskPriorities[i]));
+    printf("3. Duration: %d seconds\n", taskDurations[i]);
+    printf("4. Status: %s\n", taskCompleted[i] ? "Completed" : "Pending");
+    char prerequisites[128];
+    formatPrerequisites(taskIds[i], false, prerequisites, sizeof(prerequisites));
+    printf("5. Save and return\n");
+    printf("6. Depends on: %s\n", prerequisites[0] != '\0' ? prerequisites : "nothing");
+    
+    int choice;
+    do {
+        printf("\nSelect what to modify (1-6): ");
+        scanf("%d", &choice);
+        
+        // Description and schedule edits can change the task's duplicate key
+        bool rekey = choice >= 1 && choice <= 3;
+        if (rekey) {
+            duplicateIndexRemove(i);
+        }
+        
+        switch (choice) {
+            case 1: {
+                char description[MAX_DESCRIPTION];
+                clearInputBuffer();
+                printf("New description: ");
+                if (fgets(description, MAX_DESCRIPTION, stdin) != NULL) {
+                    description[strcspn(description, "\n")] = 0;
+                    setTaskDescription(i, description);
+                }
+                break;
+            }
+            case 2: {
+                int priorityChoice;
+                printf("Select new priority:\n");
+                printf("1. High\n");
+                printf("2. Medium\n");
+                printf("3. Low\n");
+                printf("Choice: ");
+                scanf("%d", &priorityChoice);
+                
+                switch (priorityChoice) {
+                    case 1: setTaskPriority(i, HIGH); break;
+                    case 2: setTaskPriority(i, MEDIUM); break;
+                    case 3: setTaskPriority(i, LOW); break;
+                    default: printf("Invalid choice.\n");
+                }
+                break;
+            }
+            case 3:
+                do {
+                    printf("New duration (1-3600 seconds): ");
+                    scanf("%d", &taskDurations[i]);
+                    
+                    if (taskDurations[i] < 1 || taskDurations[i] > 3600) {
+                        printf("Invalid duration.\n");
+                    }
+                } while (taskDurations[i] < 1 || taskDurations[i] > 3600);
+                break;
+            case 4:
+                setTaskCompleted(i, !taskCompleted[i]);
+                printf("Status changed to: %s\n", taskCompleted[i] ? "Completed" : "Pending");
+                break;
+            case 6: {
+                // Dependencies have their own journal record, logged as they change
+                int other;
+                printf("Task ID to wait on, -ID to stop waiting on it, or 0 to keep: ");
+                scanf("%d", &other);
+                if (other > 0 && hasDependency(taskIds[i], other)) {
+                    printf("Task %d already waits on task %d.\n", taskIds[i], other);
+                } else if (other > 0 && addDependency(taskIds[i], other)) {
+                    journalDependency(taskIds[i], other, true);
+                    printf("Task %d now waits on task %d.\n", taskIds[i], other);
+                } else if (other < 0 && other != INT_MIN) {
+                    if (removeDependency(taskIds[i], -other)) {
+                        journalDependency(taskIds[i], -other, false);
+                        printf("Task %d no longer waits on task %d.\n", taskIds[i], -other);
+                    } else {
+                        printf("Task %d does not wait on task %d.\n", taskIds[i], -other);
+                    }
+                }
+                break;
+            }
+            case 5:
+                printf("Changes saved.\n");
+                journalTask(JOURNAL_UPDATE, i);
+                return;
+            default:
+                printf("Invalid choice.\n");
+        }
+        
+        if (rekey) {
+            duplicateIndexAdd(i);
+        }
+    } while (choice != 5);
+}
+
+// Number of online CPUs (at least 1)
+int processorCount() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+// Three-way comparison of two tasks under a sort key
+int compareTaskSlots(int a, int b, SortKey key) {
+    switch (key) {
+        case SORT_BY_PRIORITY:
+            if (taskPriorities[a] != taskPriorities[b]) return taskPriorities[a] < taskPriorities[b] ? -1 : 1;
+            if (taskDurations[a] != taskDurations[b]) return taskDurations[a] < taskDurations[b] ? -1 : 1;
+            return 0;
+        case SORT_BY_DURATION:
+            if (taskDurations[a] != taskDurations[b]) return taskDurations[a] < taskDurations[b] ? -1 : 1;
+            if (taskPriorities[a] != taskPriorities[b]) return taskPriorities[a] < taskPriorities[b] ? -1 : 1;
+            return 0;
+        case SORT_BY_CREATED:
+            if (taskCreated[a] != taskCreated[b]) return taskCreated[a] > taskCreated[b] ? -1 : 1;
+            return 0;
+    }
+    return 0;
+}
+
+// Stable merge of two sorted runs of slots; ties are taken from the left run
+void mergeSlotRuns(const int *left, int leftCount, const int *right, int rightCount, int *out, SortKey key) {
+    int i = 0, j = 0, k = 0;
+    
+    while (i < leftCount && j < rightCount) {
+        if (compareTaskSlots(right[j], left[i], key) < 0) {
+            out[k++] = right[j++];
+        } else {
+            out[k++] = left[i++];
+        }
+    }
+    while (i < leftCount) out[k++] = left[i++];
+    while (j < rightCount) out[k++] = right[j++];
+}
+
+// Stable O(n log n) merge sort of slot numbers; scratch must hold count entries
+void mergeSortSlots(int *slots, int *scratch, int count, SortKey key) {
+    if (count <= SORT_INSERTION_CUTOFF) {
+        for (int i = 1; i < count; i++) {
+            int slot = slots[i];
+            int j = i - 1;
+            while (j >= 0 && compareTaskSlots(slot, slots[j], key) < 0) {
+                slots[j + 1] = slots[j];
+                j--;
+            }
+            slots[j + 1] = slot;
+        }
+        return;
+    }
+    
+    int half = count / 2;
+    mergeSortSlots(slots, scratch, half, key);
+    mergeSortSlots(slots + half, scratch + half, count - half, key);
+    
+    // Already in order: nothing to merge
+    if (compareTaskSlots(slots[half], slots[half - 1], key) >= 0) {
+        return;
+    }
+    
+    memcpy(scratch, slots, (size_t)half * sizeof(int));
+    mergeSlotRuns(scratch, half, slots + half, count - half, slots, key);
+}
+
+void* sortRangeThread(void *arg) {
+    SortRange *range = (SortRange*)arg;
+    mergeSortSlots(range->slots, range->scratch, range->count, range->key);
+    return NULL;
+}
+
+void* mergeRangeThread(void *arg) {
+    MergeRange *range = (MergeRange*)arg;
+    mergeSlotRuns(range->left, range->leftCount, range->right, range->rightCount, range->out, range->key);
+    return NULL;
+}
+
+// Sort slot numbers by key. Large inputs are cut into one chunk per thread,
+// sorted concurrently, then merged pairwise with each level's merges in parallel.
+void sortTaskSlots(int *slots, int count, SortKey key, int threads) {
+    if (count < 2) {
+        return;
+    }
+    
+    int *scratch = (int*)malloc((size_t)count * sizeof(int));
+    if (scratch == NULL) {
+        // Fall back to the in-place insertion path rather than leave the input unsorted
+        for (int i = 1; i < count; i++) {
+            int slot = slots[i];
+            int j = i - 1;
+            while (j >= 0 && compareTaskSlots(slot, slots[j], key) < 0) {
+                slots[j + 1] = slots[j];
+                j--;
+            }
+            slots[j + 1] = slot;
+        }
+        return;
+    }
+    
+    if (threads > count / (PARALLEL_SORT_THRESHOLD / 2)) {
+        threads = count / (PARALLEL_SORT_THRESHOLD / 2);
+    }
+    
+    if (threads <= 1) {
+        mergeSortSlots(slots, scratch, count, key);
+        free(scratch);
+        return;
+    }
+    
+    pthread_t *workers = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+    SortRange *ranges = (SortRange*)malloc((size_t)threads * sizeof(SortRange));
+    MergeRange *merges = (MergeRange*)malloc((size_t)threads * sizeof(MergeRange));
+    int *bounds = (int*)malloc((size_t)(threads + 1) * sizeof(int));
+    if (workers == NULL || ranges == NULL || merges == NULL || bounds == NULL) {
+        free(workers);
+        free(ranges);
+        free(merges);
+        free(bounds);
+        mergeSortSlots(slots, scratch, count, key);
+        free(scratch);
+        return;
+    }
+    
+    for (int t = 0; t <= threads; t++) {
+        bounds[t] = (int)((long long)count * t / threads);
+    }
+    
+    for (int t = 0; t < threads; t++) {
+        ranges[t].slots = slots + bounds[t];
+        ranges[t].scratch = scratch + bounds[t];
+        ranges[t].count = bounds[t + 1] - bounds[t];
+        ranges[t].key = key;
+        pthread_create(&workers[t], NULL, sortRangeThread, &ranges[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(workers[t], NULL);
+    }
+    
+    // Merge neighbouring runs, ping-ponging between the two buffers
+    int *from = slots;
+    int *to = scratch;
+    int runs = threads;
+    while (runs > 1) {
+        int merged = 0;
+        for (int r = 0; r < runs; r += 2) {
+            int start = bounds[r];
+            int middle = bounds[r + 1];
+            int end = r + 2 <= runs ? bounds[r + 2] : middle;
+            
+            merges[merged].left = from + start;
+            merges[merged].leftCount = middle - start;
+            merges[merged].right = from + middle;
+            merges[merged].rightCount = end - middle;
+            merges[merged].out = to + start;
+            merges[merged].key = key;
+            pthread_create(&workers[merged], NULL, mergeRangeThread, &merges[merged]);
+            merged++;
+        }
+        for (int m = 0; m < merged; m++) {
+            pthread_join(workers[m], NULL);
+        }
+        
+        // Keep the run boundaries that survive this level
+        for (int r = 0, m = 0; r <= runs; r += 2, m++) {
+            bounds[m] = bounds[r];
+        }
+        if (runs % 2 == 1) {
+            bounds[merged] = count;
+        }
+        runs = merged;
+        
+        int *swap = from;
+        from = to;
+        to = swap;
+    }
+    
+    if (from != slots) {
+        memcpy(slots, from, (size_t)count * sizeof(int));
+    }
+    
+    free(workers);
+    free(ranges);
+    free(merges);
+    free(bounds);
+    free(scratch);
+}
+
+// Slots of all live tasks in sorted order; the caller frees the result
+int* sortedTaskOrder(SortKey key, int *count) {
+    int *order = (int*)malloc((size_t)(taskCount > 0 ? taskCount : 1) * sizeof(int));
+    if (order == NULL) {
+        printf("Memory allocation error\n");
+        *count = 0;
+        return NULL;
+    }
+    
+    int n = 0;
+    if (key == SORT_BY_CREATED) {
+        free(order);
+        return createdTaskOrder(count);
+    }
+    
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] != 0) {
+            order[n++] = i;
+        }
+    }
+    
+    sortTaskSlots(order, n, key, processorCount());
+    *count = n;
+    return order;
+}
+
+// Rearrange the store so slot i holds the task from old slot order[i]; drops tombstones
+bool applyTaskOrder(const int *order, int count) {
+    ensureIndexes();
+    size_t n = taskCapacity > 0 ? (size_t)taskCapacity : 1;
+    int *ids = (int*)malloc(n * sizeof(int));
+    Priority *priorities = (Priority*)malloc(n * sizeof(Priority));
+    int *durations = (int*)malloc(n * sizeof(int));
+    time_t *created = (time_t*)malloc(n * sizeof(time_t));
+    bool *completed = (bool*)malloc(n * sizeof(bool));
+    unsigned int *descriptions = (unsigned int*)malloc(n * sizeof(unsigned int));
+    if (ids == NULL || priorities == NULL || durations == NULL || created == NULL ||
+        completed == NULL || descriptions == NULL) {
+        printf("Memory allocation error\n");
+        free(ids);
+        free(priorities);
+        free(durations);
+        free(created);
+        free(completed);
+        free(descriptions);
+        return false;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        int from = order[i];
+        ids[i] = taskIds[from];
+        priorities[i] = taskPriorities[from];
+        durations[i] = taskDurations[from];
+        created[i] = taskCreated[from];
+        completed[i] = taskCompleted[from];
+        descriptions[i] = taskDescriptionOffsets[from];
+    }
+    
+    freeTaskColumns();
+    taskIds = ids;
+    taskPriorities = priorities;
+    taskDurations = durations;
+    taskCreated = created;
+    taskCompleted = completed;
+    taskDescriptionOffsets = descriptions;
+    taskSlotCount = count;
+    freeSlotCount = 0;
+    rebuildIdIndex();
+    rebuildSecondaryIndexes();
+    return true;
+}
+
+// Sort tasks by priority and then duration
+void sortTasks() {
+    if (taskCount <= 1) {
+        printf("\nNothing to sort.\n");
+        return;
+    }
+    
+    printf("\n=== Sort Tasks ===\n");
+    printf("1. Sort by priority (highest first)\n");
+    printf("2. Sort by duration (shortest first)\n");
+    printf("3. Sort by creation time (newest first)\n");
+    printf("Choice: ");
+    
+    int choice;
+    scanf("%d", &choice);
+    
+    if (choice < SORT_BY_PRIORITY || choice > SORT_BY_CREATED) {
+        printf("Invalid choice. Nothing sorted.\n");
+        return;
+    }
+    
+    int count;
+    int *order = sortedTaskOrder((SortKey)choice, &count);
+    if (order == NULL) {
+        return;
+    }
+    
+    bool sorted = applyTaskOrder(order, count);
+    free(order);
+    if (!sorted) {
+        return;
+    }
+    
+    printf("Tasks sorted successfully.\n");
+    viewTasks();
+}
+
+void requestCancel(CancelToken *token) {
+    atomic_store_explicit(&token->requested, true, memory_order_release);
+}
+
+bool cancelRequested(CancelToken *token) {
+    return atomic_load_explicit(&token->requested, memory_order_acquire);
+}
+
+void cancelOnInterrupt(int signalNumber) {
+    (void)signalNumber;
+    requestCancel(&executionCancel);
+}
+
+// Let Ctrl+C cancel the run about to start instead of ending the program
+void armCancellation() {
+    atomic_store(&executionCancel.requested, false);
+    signal(SIGINT, cancelOnInterrupt);
+}
+
+void disarmCancellation() {
+    signal(SIGINT, SIG_DFL);
+}
+
+bool completionLogInit(CompletionLog *log, int capacity) {
+    log->capacity = capacity;
+    log->committer = NULL;
+    atomic_init(&log->claimed, 0);
+    log->entries = (_Atomic int*)malloc((capacity > 0 ? (size_t)capacity : 1) * sizeof(_Atomic int));
+    if (log->entries == NULL) {
+        printf("Memory allocation error\n");
+        return false;
+    }
+    for (int n = 0; n < capacity; n++) {
+        atomic_init(&log->entries[n], -1);
+    }
+    return true;
+}
+
+void completionLogFree(CompletionLog *log) {
+    free(log->entries);
+    log->entries = NULL;
+}
+
+// Append a finished job. Each job completes once, so positions never run out.
+// The job that fills a group wakes the committer; signalling without its lock
+// may miss a sleeping committer, which then commits on its timer instead.
+void completionLogPublish(CompletionLog *log, int job) {
+    int position = atomic_fetch_add_explicit(&log->claimed, 1, memory_order_relaxed);
+    atomic_store_explicit(&log->entries[position], job, memory_order_release);
+    GroupCommit *commit = log->committer;
+    if (commit != NULL &&
+        position + 1 - atomic_load_explicit(&commit->committed, memory_order_relaxed) == GROUP_COMMIT_RECORDS) {
+        pthread_cond_signal(&commit->wake);
+    }
+}
+
+// Job published at a position, or -1 if its worker has not written it yet
+int completionLogRead(CompletionLog *log, int position) {
+    return atomic_load_explicit(&log->entries[position], memory_order_acquire);
+}
+
+// Journal every completion published since the last commit, up to the first
+// position not written yet, and make them durable with one fsync. Returns the
+// number committed.
+int commitPublished(GroupCommit *commit) {
+    int first = atomic_load(&commit->committed);
+    int claimed = atomic_load(&commit->log->claimed);
+    int n = first;
+    while (n < claimed) {
+        int job = completionLogRead(commit->log, n);
+        if (job < 0) {
+            break;
+        }
+        if (!journalCompletionRecord(commit->jobs[job].task.id, true)) {
+            commit->failed = true;
+        }
+        n++;
+    }
+    if (n > first) {
+        if (!journalSync()) {
+            commit->failed = true;
+        }
+        commit->groups++;
+        atomic_store(&commit->committed, n);
+    }
+    return n - first;
+}
+
+// Commit a group whenever one is full or the interval runs out, until stopped;
+// the last commit after the stop request takes whatever is left
+void* groupCommitThread(void *arg) {
+    GroupCommit *commit = (GroupCommit*)arg;
+    for (;;) {
+        bool stopping = atomic_load(&commit->stopping);
+        commitPublished(commit);
+        if (stopping) {
+            break;
+        }
+        
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += GROUP_COMMIT_INTERVAL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&commit->lock);
+        while (!atomic_load(&commit->stopping) &&
+               atomic_load(&commit->log->claimed) - atomic_load(&commit->committed) < GROUP_COMMIT_RECORDS) {
+            if (pthread_cond_timedwait(&commit->wake, &commit->lock, &deadline) != 0) {
+                break;   // interval over: commit what there is
+            }
+        }
+        pthread_mutex_unlock(&commit->lock);
+    }
+    return NULL;
+}
+
+// Start committing a run's completions in the background as they are published
+bool startGroupCommit(GroupCommit *commit, CompletionLog *log, const ExecutionJob *jobs) {
+    commit->log = log;
+    commit->jobs = jobs;
+    commit->groups = 0;
+    commit->failed = false;
+    atomic_init(&commit->committed, 0);
+    atomic_init(&commit->stopping, false);
+    pthread_mutex_init(&commit->lock, NULL);
+    pthread_cond_init(&commit->wake, NULL);
+    log->committer = commit;
+    if (pthread_create(&commit->thread, NULL, groupCommitThread, commit) != 0) {
+        printf("Error: Cannot start the journal thread.\n");
+        log->committer = NULL;
+        pthread_mutex_destroy(&commit->lock);
+        pthread_cond_destroy(&commit->wake);
+        return false;
+    }
+    return true;
+}
+
+// Commit what is left once the run has ended, and stop the thread
+void stopGroupCommit(GroupCommit *commit) {
+    pthread_mutex_lock(&commit->lock);
+    atomic_store(&commit->stopping, true);
+    pthread_cond_signal(&commit->wake);
+    pthread_mutex_unlock(&commit->lock);
+    pthread_join(commit->thread, NULL);
+    commit->log->committer = NULL;
+    pthread_mutex_destroy(&commit->lock);
+    pthread_cond_destroy(&commit->wake);
+}
+
+// Simulate one task on a worker. Returns false if the run was cancelled
+// before the countdown ran out.
+bool runExecutionJob(int worker, const ExecutionJob *job) {
+    const Task *task = &job->task;
+    
+    printf("\n[Worker %d] Executing: %s (ID: %d) | Priority: %s | Duration: %d sec\n",
+           worker + 1, task->description, task->id, 
+           priorityToString(task->priority), task->duration);
+    
+    // Countdown timer
+    for (int j = task->duration; j > 0; j--) {
+        if (cancelRequested(&executionCancel)) {
+            printf("\r[Worker %d] Task %d cancelled with %d seconds left.\n", worker + 1, task->id, j);
+            return false;
+        }
+        printf("\r[Worker %d] Time remaining: %d seconds...   ", worker + 1, j);
+        fflush(stdout);
+        sleep(1);  // Simulate execution
+    }
+    
+    printf("\r[Worker %d] Task %d completed!                  \n", worker + 1, task->id);
+    return true;
+}
+
+WorkBuffer* allocWorkBuffer(long long capacity) {
+    WorkBuffer *buffer = (WorkBuffer*)malloc(sizeof(WorkBuffer) + (size_t)capacity * sizeof(_Atomic int));
+    if (buffer != NULL) {
+        buffer->capacity = capacity;
+        buffer->previous = NULL;
+    }
+    return buffer;
+}
+
+bool dequeInit(WorkDeque *deque, long long capacity) {
+    WorkBuffer *buffer = allocWorkBuffer(capacity);
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->buffer, buffer);
+    return buffer != NULL;
+}
+
+// Empty a deque between batches and free the buffers it outgrew
+void dequeReset(WorkDeque *deque) {
+    WorkBuffer *buffer = atomic_load(&deque->buffer);
+    while (buffer->previous != NULL) {
+        WorkBuffer *old = buffer->previous;
+        buffer->previous = old->previous;
+        free(old);
+    }
+    atomic_store(&deque->top, 0);
+    atomic_store(&deque->bottom, 0);
+}
+
+void dequeFree(WorkDeque *deque) {
+    WorkBuffer *buffer = atomic_load(&deque->buffer);
+    while (buffer != NULL) {
+        WorkBuffer *old = buffer;
+        buffer = buffer->previous;
+        free(old);
+    }
+    atomic_store(&deque->buffer, NULL);
+}
+
+// Owner only: add a job at the bottom, doubling the buffer when full
+bool dequePush(WorkDeque *deque, int item) {
+    long long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long long t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    WorkBuffer *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    
+    if (b - t > buffer->capacity - 1) {
+        WorkBuffer *grown = allocWorkBuffer(buffer->capacity * 2);
+        if (grown == NULL) {
+            return false;
+        }
+        for (long long i = t; i < b; i++) {
+            atomic_store_explicit(&grown->items[i & (grown->capacity - 1)],
+                                  atomic_load_explicit(&buffer->items[i & (buffer->capacity - 1)], memory_order_relaxed),
+                                  memory_order_relaxed);
+        }
+        grown->previous = buffer;
+        atomic_store_explicit(&deque->buffer, grown, memory_order_release);
+        buffer = grown;
+    }
+    
+    atomic_store_explicit(&buffer->items[b & (buffer->capacity - 1)], item, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    return true;
+}
+
+// Owner only: take the most recently pushed job, or WORK_EMPTY
+int dequeTake(WorkDeque *deque) {
+    long long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    WorkBuffer *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    
+    if (t > b) {
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return WORK_EMPTY;
+    }
+    
+    int item = atomic_load_explicit(&buffer->items[b & (buffer->capacity - 1)], memory_order_relaxed);
+    if (t == b) {
+        // Last job: race any thief for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            item = WORK_EMPTY;
+        }
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    }
+    return item;
+}
+
+// Any thread: take the oldest job, WORK_EMPTY, or WORK_ABORT on a lost race
+int dequeSteal(WorkDeque *deque) {
+    long long t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (t >= b) {
+        return WORK_EMPTY;
+    }
+    
+    WorkBuffer *buffer = atomic_load_explicit(&deque->buffer, memory_order_acquire);
+    int item = atomic_load_explicit(&buffer->items[t & (buffer->capacity - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return WORK_ABORT;
+    }
+    return item;
+}
+
+// A worker's deque for one priority level (0 = High)
+WorkDeque* workerDeque(int worker, int level) {
+    return &executor.deques[worker * DISPATCH_LEVELS + level];
+}
+
+// Steal a job of one level from a victim picked at random. Returns
+// WORK_EMPTY once a full pass finds that level empty on every other worker.
+int stealExecutionJob(int worker, int level, unsigned int *seed) {
+    for (;;) {
+        bool contended = false;
+        *seed = *seed * 1103515245u + 12345u;
+        int start = (int)((*seed >> 16) % (unsigned int)executor.workerCount);
+        for (int k = 0; k < executor.workerCount; k++) {
+            int victim = (start + k) % executor.workerCount;
+            if (victim == worker) {
+                continue;
+            }
+            int job = dequeSteal(workerDeque(victim, level));
+            if (job >= 0) {
+                atomic_fetch_add_explicit(&executor.steals, 1, memory_order_relaxed);
+                return job;
+            }
+            contended = contended || job == WORK_ABORT;
+        }
+        if (!contended) {
+            return WORK_EMPTY;
+        }
+    }
+}
+
+// A worker's next job, highest priority first: its own at that level, else
+// one stolen at that level, and only then the next level down. Independent
+// jobs are all dealt before the batch opens, so once a level is seen empty
+// everywhere no job of that priority is left waiting until a finished job
+// releases one. Returns WORK_EMPTY when nothing is ready.
+int nextExecutionJob(int worker, unsigned int *seed) {
+    bool stealing = executor.stealing && executor.workerCount > 1;
+    for (int level = 0; level < DISPATCH_LEVELS; level++) {
+        int job = dequeTake(workerDeque(worker, level));
+        if (job == WORK_EMPTY && stealing) {
+            job = stealExecutionJob(worker, level, seed);
+        }
+        if (job >= 0) {
+            return job;
+        }
+    }
+    return WORK_EMPTY;
+}
+
+// Deque level a job is dealt to
+int jobLevel(const ExecutionJob *job) {
+    return executor.priorityLevels ? priorityBucket(job->task.priority) : 0;
+}
+
+// Count down the jobs waiting on a finished one and queue those it frees on
+// this worker's own deques, then wake any worker sleeping for work
+void releaseSuccessors(int worker, int job) {
+    const JobGraph *graph = executor.graph;
+    bool released = false;
+    for (int k = graph->successorStart[job]; k < graph->successorStart[job + 1]; k++) {
+        int s = graph->successors[k];
+        if (atomic_fetch_sub(&executor.waitingOn[s], 1) != 1) {
+            continue;
+        }
+        if (dequePush(workerDeque(worker, jobLevel(&executor.jobs[s])), s)) {
+            released = true;
+        } else {
+            // Out of memory growing the deque: run it here rather than lose it
+            completeExecutionJob(worker, s);
+        }
+    }
+    if (released) {
+        pthread_mutex_lock(&executor.lock);
+        atomic_fetch_add(&executor.releases, 1);
+        pthread_cond_broadcast(&executor.jobsReleased);
+        pthread_mutex_unlock(&executor.lock);
+    }
+}
+
+// Claim a job and run it unless the run was cancelled, publish how it ended,
+// release the jobs waiting on it, then count it done. Releasing first means
+// the count cannot reach zero while freed jobs are still queued. Jobs freed
+// after a cancel are claimed and marked cancelled the same way, so the batch
+// still drains.
+void completeExecutionJob(int worker, int job) {
+    int expected = JOB_PENDING;
+    if (!atomic_compare_exchange_strong(&executor.jobStates[job], &expected, JOB_RUNNING)) {
+        return;   // already claimed elsewhere, which also counts it
+    }
+    bool finished = !cancelRequested(&executionCancel) && executor.runJob(worker, &executor.jobs[job]);
+    atomic_store_explicit(&executor.jobStates[job], finished ? JOB_DONE : JOB_CANCELLED, memory_order_release);
+    if (finished && executor.completions != NULL) {
+        completionLogPublish(executor.completions, job);
+    }
+    if (executor.graph != NULL) {
+        releaseSuccessors(worker, job);
+    }
+    if (atomic_fetch_sub(&executor.unfinished, 1) == 1) {
+        pthread_mutex_lock(&executor.lock);
+        pthread_cond_signal(&executor.batchDone);
+        pthread_cond_broadcast(&executor.jobsReleased);
+        pthread_mutex_unlock(&executor.lock);
+    }
+}
+
+// Sleep until some job is released after `releasesSeen` was read, or the
+// batch is done. Reading the count before looking for work means a release
+// that lands in between is never missed. Returns false once the batch is done.
+bool waitForReleasedJobs(int releasesSeen) {
+    pthread_mutex_lock(&executor.lock);
+    while (atomic_load(&executor.releases) == releasesSeen && atomic_load(&executor.unfinished) > 0) {
+        pthread_cond_wait(&executor.jobsReleased, &executor.lock);
+    }
+    bool more = atomic_load(&executor.unfinished) > 0;
+    pthread_mutex_unlock(&executor.lock);
+    return more;
+}
+
+// Worker loop: join each batch, run jobs until none are left anywhere, repeat
+// until shutdown. The lock is only taken to join and leave a batch, and to
+// sleep while a batch with dependencies has nothing ready.
+void* executorWorker(void *arg) {
+    int worker = (int)(intptr_t)arg;
+    unsigned int seed = 2463534242u + (unsigned int)worker * 7919u;
+    int seenBatch = 0;
+    
+    pthread_mutex_lock(&executor.lock);
+    for (;;) {
+        while (!executor.shutdown && (!executor.batchOpen || executor.batch == seenBatch)) {
+            pthread_cond_wait(&executor.workReady, &executor.lock);
+        }
+        if (executor.shutdown) {
+            break;
+        }
+        seenBatch = executor.batch;
+        executor.activeWorkers++;
+        pthread_mutex_unlock(&executor.lock);
+        
+        for (;;) {
+            int releasesSeen = atomic_load(&executor.releases);
+            int job = nextExecutionJob(worker, &seed);
+            if (job >= 0) {
+                completeExecutionJob(worker, job);
+            } else if (executor.graph == NULL || !waitForReleasedJobs(releasesSeen)) {
+                break;
+            }
+        }
+        
+        pthread_mutex_lock(&executor.lock);
+        if (--executor.activeWorkers == 0) {
+            pthread_cond_signal(&executor.batchDone);
+        }
+    }
+    pthread_mutex_unlock(&executor.lock);
+    return NULL;
+}
+
+// Make sure the pool has `workers` threads, resizing it only if the count changed
+bool startExecutor(int workers) {
+    if (executor.workerCount == workers) {
+        return true;
+    }
+    stopExecutor();
+    
+    executor.threads = (pthread_t*)malloc((size_t)workers * sizeof(pthread_t));
+    int dequeCount = workers * DISPATCH_LEVELS;
+    executor.deques = (WorkDeque*)calloc((size_t)dequeCount, sizeof(WorkDeque));
+    bool ready = executor.threads != NULL && executor.deques != NULL;
+    for (int d = 0; d < dequeCount && ready; d++) {
+        ready = dequeInit(&executor.deques[d], WORK_DEQUE_MIN_CAPACITY);
+    }
+    if (!ready) {
+        printf("Memory allocation error\n");
+        for (int d = 0; executor.deques != NULL && d < dequeCount; d++) {
+            dequeFree(&executor.deques[d]);
+        }
+        free(executor.threads);
+        free(executor.deques);
+        executor.threads = NULL;
+        executor.deques = NULL;
+        return false;
+    }
+    
+    executor.shutdown = false;
+    executor.batchOpen = false;
+    executor.activeWorkers = 0;
+    if (executor.runJob == NULL) {
+        executor.runJob = runExecutionJob;
+    }
+    for (int w = 0; w < workers; w++) {
+        if (pthread_create(&executor.threads[w], NULL, executorWorker, (void*)(intptr_t)w) != 0) {
+            printf("Error: Could only start %d of %d worker threads.\n", w, workers);
+            for (int d = w * DISPATCH_LEVELS; d < dequeCount; d++) {
+                dequeFree(&executor.deques[d]);
+            }
+            workers = w;
+            break;
+        }
+    }
+    executor.workerCount = workers;
+    if (workers == 0) {
+        free(executor.threads);
+        free(executor.deques);
+        executor.threads = NULL;
+        executor.deques = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Let idle workers exit and join them
+void stopExecutor() {
+    if (executor.workerCount == 0) {
+        return;
+    }
+    
+    pthread_mutex_lock(&executor.lock);
+    executor.shutdown = true;
+    pthread_cond_broadcast(&executor.workReady);
+    pthread_mutex_unlock(&executor.lock);
+    
+    for (int w = 0; w < executor.workerCount; w++) {
+        pthread_join(executor.threads[w], NULL);
+        for (int level = 0; level < DISPATCH_LEVELS; level++) {
+            dequeFree(workerDeque(w, level));
+        }
+    }
+    free(executor.threads);
+    free(executor.deques);
+    executor.threads = NULL;
+    executor.deques = NULL;
+    executor.workerCount = 0;
+}
+
+// Deal a batch of jobs across the worker deques as the plan says, open the
+// batch and wait until every job has run and every worker has left it. Under
+// the priority policy each priority goes on its own level; other policies
+// put everything on one. Deques are filled back to front so an owner starts
+// with its earliest planned job while thieves take its latest. With a job
+// graph only the jobs waiting on nothing are dealt; the rest are released as
+// their prerequisites finish. Jobs that finish are published to
+// `completions` when given; cancelled ones are not. The jobs array is not
+// reordered.
+void executeBatch(ExecutionJob *jobs, int count, const SchedulePlan *plan, const JobGraph *graph,
+                  CompletionLog *completions) {
+    if (count == 0) {
+        return;
+    }
+    
+    int workers = executor.workerCount;
+    bool dependent = graph != NULL && graph->edgeCount > 0;
+    _Atomic int *waitingOn = dependent ? (_Atomic int*)malloc((size_t)count * sizeof(_Atomic int)) : NULL;
+    _Atomic int *jobStates = (_Atomic int*)malloc((size_t)count * sizeof(_Atomic int));
+    if ((dependent && waitingOn == NULL) || jobStates == NULL) {
+        printf("Memory allocation error\n");
+        free(waitingOn);
+        free(jobStates);
+        return;
+    }
+    for (int j = 0; j < count; j++) {
+        atomic_init(&jobStates[j], JOB_PENDING);
+        if (dependent) {
+            atomic_init(&waitingOn[j], graph->predecessorCount[j]);
+        }
+    }
+    
+    executor.priorityLevels = plan->policy == POLICY_PRIORITY;
+    int skipped = 0;
+    for (int k = count - 1; k >= 0; k--) {
+        int j = plan->order[k];
+        if (dependent && graph->predecessorCount[j] > 0) {
+            continue;
+        }
+        if (!dequePush(workerDeque(plan->worker[j] % workers, jobLevel(&jobs[j])), j)) {
+            // Out of memory: this job is skipped rather than run
+            skipped++;
+        }
+    }
+    if (skipped > 0) {
+        printf("Memory allocation error\n");
+        if (dependent) {
+            // Jobs waiting on a skipped one would never be released
+            for (int d = 0; d < workers * DISPATCH_LEVELS; d++) {
+                dequeReset(&executor.deques[d]);
+            }
+            free(waitingOn);
+            free(jobStates);
+            return;
+        }
+    }
+    
+    pthread_mutex_lock(&executor.lock);
+    executor.jobs = jobs;
+    executor.graph = dependent ? graph : NULL;
+    executor.waitingOn = waitingOn;
+    executor.jobStates = jobStates;
+    executor.completions = completions;
+    atomic_store(&executor.unfinished, count - skipped);
+    atomic_store(&executor.steals, 0);
+    executor.batch++;
+    executor.batchOpen = true;
+    pthread_cond_broadcast(&executor.workReady);
+    
+    while (atomic_load(&executor.unfinished) > 0 || executor.activeWorkers > 0) {
+        pthread_cond_wait(&executor.batchDone, &executor.lock);
+    }
+    executor.batchOpen = false;
+    executor.jobs = NULL;
+    executor.graph = NULL;
+    executor.waitingOn = NULL;
+    executor.jobStates = NULL;
+    executor.completions = NULL;
+    pthread_mutex_unlock(&executor.lock);
+    
+    for (int d = 0; d < workers * DISPATCH_LEVELS; d++) {
+        dequeReset(&executor.deques[d]);
+    }
+    free(waitingOn);
+    free(jobStates);
+}
+
+// Ask how many workers to run; an empty line keeps the default of one per core
+int readWorkerCount() {
+    int workers = executor.workerCount > 0 ? executor.workerCount : processorCount();
+    printf("Worker threads (1-%d, Enter for %d): ", MAX_EXECUTOR_WORKERS, workers);
+    char *line = readLine(stdin);
+    if (line != NULL) {
+        int requested = atoi(line);
+        if (requested >= 1 && requested <= MAX_EXECUTOR_WORKERS) {
+            workers = requested;
+        } else if (line[strspn(line, " \t")] != '\0') {
+            printf("Invalid worker count. Using %d.\n", workers);
+        }
+        free(line);
+    }
+    return workers;
+}
+
+const char* policyName(SchedulePolicy policy) {
+    switch (policy) {
+        case POLICY_FIFO: return "FIFO";
+        case POLICY_PRIORITY: return "Priority";
+        case POLICY_SJF: return "SJF";
+        case POLICY_LPT: return "LPT";
+        case POLICY_WEIGHTED: return "Weighted";
+        default: return "Unknown";
+    }
+}
+
+// Weight of a priority for the weighted policy; each level counts double the one below
+int priorityWeight(Priority p) {
+    switch (p) {
+        case HIGH: return 4;
+        case MEDIUM: return 2;
+        default: return 1;
+    }
+}
+
+// Sort key of a job under a policy, smallest first. The weights are powers
+// of two no larger than High's, so the weighted key is exactly duration / weight
+// scaled by High's weight.
+long long policySortKey(const Task *t, SchedulePolicy policy) {
+    switch (policy) {
+        case POLICY_PRIORITY:
+            return t->priority;
+        case POLICY_SJF:
+            return t->duration;
+        case POLICY_LPT:
+            return -(long long)t->duration;
+        case POLICY_WEIGHTED:
+            return (long long)t->duration * priorityWeight(HIGH) / priorityWeight(t->priority);
+        default:
+            return 0;
+    }
+}
+
+// Ties keep list order, so every policy gives a stable, repeatable plan
+int comparePlanKeys(const void *a, const void *b) {
+    const PlanKey *x = (const PlanKey*)a;
+    const PlanKey *y = (const PlanKey*)b;
+    if (x->key != y->key) {
+        return x->key < y->key ? -1 : 1;
+    }
+    return (x->job > y->job) - (x->job < y->job);
+}
+
+// Heap order: earlier time first, ties to the lower id
+bool timedEntryBefore(const TimedEntry *a, const TimedEntry *b) {
+    return a->time < b->time || (a->time == b->time && a->id < b->id);
+}
+
+// Restore the min-heap below i after its entry moved later
+void siftDownTimed(TimedEntry *heap, int count, int i) {
+    for (;;) {
+        int smallest = i;
+        for (int child = 2 * i + 1; child <= 2 * i + 2 && child < count; child++) {
+            if (timedEntryBefore(&heap[child], &heap[smallest])) {
+                smallest = child;
+            }
+        }
+        if (smallest == i) {
+            return;
+        }
+        TimedEntry swap = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = swap;
+        i = smallest;
+    }
+}
+
+// Restore the min-heap above a newly added entry at i
+void siftUpTimed(TimedEntry *heap, int i) {
+    while (i > 0 && timedEntryBefore(&heap[i], &heap[(i - 1) / 2])) {
+        TimedEntry swap = heap[i];
+        heap[i] = heap[(i - 1) / 2];
+        heap[(i - 1) / 2] = swap;
+        i = (i - 1) / 2;
+    }
+}
+
+// Build a batch's job graph from edges from[e] -> to[e] (to waits on from),
+// checking it for cycles with Kahn's algorithm and finding its critical path
+// along the topological order. O(jobs + edges).
+bool buildJobGraphFromEdges(JobGraph *graph, const ExecutionJob *jobs, int count,
+                            const int *from, const int *to, int edgeCount) {
+    memset(graph, 0, sizeof(JobGraph));
+    graph->edgeCount = edgeCount;
+    graph->successorStart = (int*)calloc((size_t)count + 1, sizeof(int));
+    graph->successors = (int*)malloc(((size_t)edgeCount + 1) * sizeof(int));
+    graph->predecessorCount = (int*)calloc((size_t)count + 1, sizeof(int));
+    int *topological = (int*)malloc(((size_t)count + 1) * sizeof(int));
+    int *remaining = (int*)malloc(((size_t)count + 1) * sizeof(int));
+    long long *finish = (long long*)calloc((size_t)count + 1, sizeof(long long));
+    int *via = (int*)malloc(((size_t)count + 1) * sizeof(int));
+    bool built = graph->successorStart != NULL && graph->successors != NULL && graph->predecessorCount != NULL &&
+                 topological != NULL && remaining != NULL && finish != NULL && via != NULL;
+    if (!built) {
+        printf("Memory allocation error\n");
+    }
+    
+    // Successor lists by counting sort on the source job
+    for (int e = 0; built && e < edgeCount; e++) {
+        graph->successorStart[from[e] + 1]++;
+        graph->predecessorCount[to[e]]++;
+    }
+    for (int j = 0; built && j < count; j++) {
+        graph->successorStart[j + 1] += graph->successorStart[j];
+    }
+    for (int j = 0; built && j < count; j++) {
+        remaining[j] = 0;   // fill cursor per source job
+    }
+    for (int e = 0; built && e < edgeCount; e++) {
+        graph->successors[graph->successorStart[from[e]] + remaining[from[e]]++] = to[e];
+    }
+    
+    // Kahn's algorithm; `topological` doubles as its queue
+    int head = 0, tail = 0;
+    for (int j = 0; built && j < count; j++) {
+        remaining[j] = graph->predecessorCount[j];
+        via[j] = -1;
+        if (remaining[j] == 0) {
+            topological[tail++] = j;
+        }
+    }
+    while (built && head < tail) {
+        int j = topological[head++];
+        finish[j] += jobs[j].task.duration;
+        for (int k = graph->successorStart[j]; k < graph->successorStart[j + 1]; k++) {
+            int s = graph->successors[k];
+            if (finish[j] > finish[s]) {
+                finish[s] = finish[j];   // earliest start so far
+                via[s] = j;
+            }
+            if (--remaining[s] == 0) {
+                topological[tail++] = s;
+            }
+        }
+    }
+    
+    if (built && tail < count) {
+        printf("Error: Dependency cycle among tasks");
+        int shown = 0;
+        for (int j = 0; j < count && shown < 10; j++) {
+            if (remaining[j] > 0) {
+                printf("%s %d", shown++ > 0 ? "," : "", jobs[j].task.id);
+            }
+        }
+        printf("%s. Remove one of those dependencies to run them.\n", count - tail > 10 ? ", ..." : "");
+        built = false;
+    }
+    
+    if (built) {
+        int last = -1;
+        for (int j = 0; j < count; j++) {
+            if (last < 0 || finish[j] > finish[last]) {
+                last = j;
+            }
+        }
+        graph->criticalLength = last >= 0 ? finish[last] : 0;
+        for (int j = last; j >= 0; j = via[j]) {
+            graph->criticalCount++;
+        }
+        graph->criticalPath = (int*)malloc(((size_t)graph->criticalCount + 1) * sizeof(int));
+        if (graph->criticalPath == NULL) {
+            printf("Memory allocation error\n");
+            built = false;
+        }
+        int k = graph->criticalCount;
+        for (int j = last; built && j >= 0; j = via[j]) {
+            graph->criticalPath[--k] = j;
+        }
+    }
+    
+    free(topological);
+    free(remaining);
+    free(finish);
+    free(via);
+    if (!built) {
+        freeJobGraph(graph);
+    }
+    return built;
+}
+
+// Job graph of a batch drawn from the task store. Only edges between jobs of
+// the batch count; prerequisites outside it are complete or deleted, since
+// selectExecutionJobs() pulls pending ones in.
+bool buildJobGraph(JobGraph *graph, const ExecutionJob *jobs, int count) {
+    ensureDependenciesSorted();
+    int *jobOfSlot = (int*)malloc(((size_t)taskSlotCount + 1) * sizeof(int));
+    int *from = (int*)malloc(((size_t)dependencyCount + 1) * sizeof(int));
+    int *to = (int*)malloc(((size_t)dependencyCount + 1) * sizeof(int));
+    if (jobOfSlot == NULL || from == NULL || to == NULL) {
+        printf("Memory allocation error\n");
+        free(jobOfSlot);
+        free(from);
+        free(to);
+        memset(graph, 0, sizeof(JobGraph));
+        return false;
+    }
+    
+    for (int i = 0; i < taskSlotCount; i++) {
+        jobOfSlot[i] = -1;
+    }
+    for (int j = 0; j < count; j++) {
+        jobOfSlot[jobs[j].slot] = j;
+    }
+    int edgeCount = 0;
+    for (int e = 0; e < dependencyCount; e++) {
+        int taskSlot = findTaskIndex(dependencies[e].task);
+        int prerequisiteSlot = findTaskIndex(dependencies[e].prerequisite);
+        if (taskSlot >= 0 && prerequisiteSlot >= 0 && jobOfSlot[taskSlot] >= 0 && jobOfSlot[prerequisiteSlot] >= 0) {
+            from[edgeCount] = jobOfSlot[prerequisiteSlot];
+            to[edgeCount] = jobOfSlot[taskSlot];
+            edgeCount++;
+        }
+    }
+    
+    bool built = buildJobGraphFromEdges(graph, jobs, count, from, to, edgeCount);
+    free(jobOfSlot);
+    free(from);
+    free(to);
+    return built;
+}
+
+void freeJobGraph(JobGraph *graph) {
+    free(graph->successorStart);
+    free(graph->successors);
+    free(graph->predecessorCount);
+    free(graph->criticalPath);
+    memset(graph, 0, sizeof(JobGraph));
+}
+
+// Plan a batch by simulating list scheduling: whenever a worker frees up it
+// starts the ready job that comes first in policy order, and a job becomes
+// ready once every job it waits on has finished. Heaps of worker free times,
+// running jobs and ready jobs keep that O(n log n) on top of the policy
+// sort. With no graph every job is ready at once.
+bool buildSchedulePlan(SchedulePlan *plan, const ExecutionJob *jobs, int count, int workers,
+                       SchedulePolicy policy, const JobGraph *graph) {
+    memset(plan, 0, sizeof(SchedulePlan));
+    plan->policy = policy;
+    plan->workers = workers;
+    plan->count = count;
+    bool dependent = graph != NULL && graph->edgeCount > 0;
+    
+    size_t allocated = count > 0 ? (size_t)count : 1;
+    plan->order = (int*)malloc(allocated * sizeof(int));
+    plan->worker = (int*)malloc(allocated * sizeof(int));
+    plan->start = (long long*)malloc(allocated * sizeof(long long));
+    PlanKey *keys = (PlanKey*)malloc(allocated * sizeof(PlanKey));
+    TimedEntry *clocks = (TimedEntry*)malloc((size_t)workers * sizeof(TimedEntry));
+    TimedEntry *ready = (TimedEntry*)malloc(allocated * sizeof(TimedEntry));
+    TimedEntry *running = dependent ? (TimedEntry*)malloc((size_t)workers * sizeof(TimedEntry)) : NULL;
+    int *rank = dependent ? (int*)malloc(allocated * sizeof(int)) : NULL;
+    int *waiting = dependent ? (int*)malloc(allocated * sizeof(int)) : NULL;
+    if (plan->order == NULL || plan->worker == NULL || plan->start == NULL || keys == NULL || clocks == NULL ||
+        ready == NULL || (dependent && (running == NULL || rank == NULL || waiting == NULL))) {
+        printf("Memory allocation error\n");
+        free(keys);
+        free(clocks);
+        free(ready);
+        free(running);
+        free(rank);
+        free(waiting);
+        freeSchedulePlan(plan);
+        return false;
+    }
+    
+    for (int j = 0; j < count; j++) {
+        keys[j].key = policySortKey(&jobs[j].task, policy);
+        keys[j].job = j;
+    }
+    if (policy != POLICY_FIFO) {
+        qsort(keys, count, sizeof(PlanKey), comparePlanKeys);
+    }
+    
+    // Ready jobs keyed by rank; added in rank order, so already a valid heap
+    int readyCount = 0;
+    for (int k = 0; k < count; k++) {
+        int j = keys[k].job;
+        if (dependent) {
+            rank[j] = k;
+            waiting[j] = graph->predecessorCount[j];
+            if (waiting[j] > 0) {
+                continue;
+            }
+        }
+        ready[readyCount].time = k;
+        ready[readyCount].id = j;
+        readyCount++;
+    }
+    free(keys);
+    
+    // All free at time 0 and ordered by worker, which is already a valid heap
+    for (int w = 0; w < workers; w++) {
+        clocks[w].time = 0;
+        clocks[w].id = w;
+    }
+    
+    long long now = 0;
+    long long totalCompletion = 0;
+    int planned = 0;
+    int runningCount = 0;
+    int readyHead = 0;   // independent jobs are taken straight off the sorted list
+    while (planned < count) {
+        while (readyCount > readyHead && clocks[0].time <= now) {
+            int j;
+            if (dependent) {
+                j = ready[0].id;
+                ready[0] = ready[--readyCount];
+                siftDownTimed(ready, readyCount, 0);
+            } else {
+                j = ready[readyHead++].id;
+            }
+            
+            plan->order[planned++] = j;
+            plan->worker[j] = clocks[0].id;
+            plan->start[j] = now;
+            long long finish = now + jobs[j].task.duration;
+            clocks[0].time = finish;
+            siftDownTimed(clocks, workers, 0);
+            
+            totalCompletion += finish;
+            if (finish > plan->makespan) {
+                plan->makespan = finish;
+            }
+            if (jobs[j].task.priority == HIGH && finish > plan->highMakespan) {
+                plan->highMakespan = finish;
+            }
+            if (dependent) {
+                running[runningCount].time = finish;
+                running[runningCount].id = j;
+                siftUpTimed(running, runningCount++);
+            }
+        }
+        
+        // Move on to the next finish and release the jobs that waited on it
+        if (runningCount > 0) {
+            now = running[0].time;
+        } else if (readyCount > readyHead) {
+            now = clocks[0].time;
+        } else {
+            break;   // nothing can start: only a cycle leaves jobs waiting
+        }
+        while (runningCount > 0 && running[0].time <= now) {
+            int j = running[0].id;
+            running[0] = running[--runningCount];
+            siftDownTimed(running, runningCount, 0);
+            for (int k = graph->successorStart[j]; k < graph->successorStart[j + 1]; k++) {
+                int s = graph->successors[k];
+                if (--waiting[s] == 0) {
+                    ready[readyCount].time = rank[s];
+                    ready[readyCount].id = s;
+                    siftUpTimed(ready, readyCount++);
+                }
+            }
+        }
+    }
+    plan->count = planned;
+    plan->meanCompletion = planned > 0 ? (double)totalCompletion / planned : 0.0;
+    
+    free(clocks);
+    free(ready);
+    free(running);
+    free(rank);
+    free(waiting);
+    return true;
+}
+
+void freeSchedulePlan(SchedulePlan *plan) {
+    free(plan->order);
+    free(plan->worker);
+    free(plan->start);
+    plan->order = NULL;
+    plan->worker = NULL;
+    plan->start = NULL;
+}
+
+// The chain of dependencies that bounds the run's wall-clock time
+void printCriticalPath(const JobGraph *graph, const ExecutionJob *jobs) {
+    printf("Critical path: %lld seconds through %d task(s): ", graph->criticalLength, graph->criticalCount);
+    for (int k = 0; k < graph->criticalCount; k++) {
+        if (k == 8 && graph->criticalCount > 10) {
+            printf(" -> ... (%d more)", graph->criticalCount - 9);
+            k = graph->criticalCount - 1;
+        }
+        printf("%s%d", k > 0 ? " -> " : "", jobs[graph->criticalPath[k]].task.id);
+    }
+    printf("\n");
+}
+
+// Print a plan's predicted makespan and, per worker, its load and the first
+// few jobs of its timeline. One pass over the plan, however many jobs.
+void printSchedulePlan(const SchedulePlan *plan, const ExecutionJob *jobs, const JobGraph *graph) {
+    int workers = plan->workers;
+    int *jobCounts = (int*)calloc((size_t)workers, sizeof(int));
+    long long *finish = (long long*)calloc((size_t)workers, sizeof(long long));
+    int *preview = (int*)malloc((size_t)workers * PLAN_TIMELINE_PREVIEW * sizeof(int));
+    if (jobCounts == NULL || finish == NULL || preview == NULL) {
+        printf("Memory allocation error\n");
+        free(jobCounts);
+        free(finish);
+        free(preview);
+        return;
+    }
+    
+    long long totalDuration = 0;
+    int longest = 0;
+    for (int k = 0; k < plan->count; k++) {
+        int j = plan->order[k];
+        int w = plan->worker[j];
+        if (jobCounts[w] < PLAN_TIMELINE_PREVIEW) {
+            preview[w * PLAN_TIMELINE_PREVIEW + jobCounts[w]] = j;
+        }
+        jobCounts[w]++;
+        finish[w] = plan->start[j] + jobs[j].task.duration;
+        totalDuration += jobs[j].task.duration;
+        if (jobs[j].task.duration > longest) longest = jobs[j].task.duration;
+    }
+    long long lowerBound = (totalDuration + workers - 1) / workers;
+    if (longest > lowerBound) lowerBound = longest;
+    if (graph != NULL && graph->criticalLength > lowerBound) lowerBound = graph->criticalLength;
+    
+    printf("\n=== Schedule Plan: %s, %d tasks on %d worker(s) ===\n", policyName(plan->policy), plan->count, workers);
+    printf("Predicted makespan: %lld seconds (lower bound %lld)\n", plan->makespan, lowerBound);
+    printf("Mean completion time: %.0f seconds\n", plan->meanCompletion);
+    if (plan->highMakespan > 0) {
+        printf("Last High priority task done at: %lld seconds\n", plan->highMakespan);
+    }
+    if (graph != NULL && graph->edgeCount > 0) {
+        printf("Dependencies: %d\n", graph->edgeCount);
+        printCriticalPath(graph, jobs);
+    }
+    
+    printf("\n%-7s %8s %10s %8s  %s\n", "Worker", "Tasks", "Done at", "Idle", "Timeline (ID start-end)");
+    for (int w = 0; w < workers; w++) {
+        printf("%-7d %8d %10lld %8lld  ", w + 1, jobCounts[w], finish[w], plan->makespan - finish[w]);
+        int shown = jobCounts[w] < PLAN_TIMELINE_PREVIEW ? jobCounts[w] : PLAN_TIMELINE_PREVIEW;
+        for (int n = 0; n < shown; n++) {
+            int j = preview[w * PLAN_TIMELINE_PREVIEW + n];
+            printf("%s#%d %lld-%lld", n > 0 ? ", " : "", jobs[j].task.id,
+                   plan->start[j], plan->start[j] + jobs[j].task.duration);
+        }
+        if (jobCounts[w] > shown) {
+            printf(", ... (+%d more)", jobCounts[w] - shown);
+        }
+        printf("\n");
+    }
+    
+    free(jobCounts);
+    free(finish);
+    free(preview);
+}
+
+// Predicted makespan and completion times of the same batch under every policy
+void comparePolicies(const ExecutionJob *jobs, int count, int workers, const JobGraph *graph) {
+    printf("\n%-10s %12s %16s %16s\n", "Policy", "Makespan", "Mean completion", "Last High done");
+    for (int p = 1; p <= SCHEDULE_POLICY_COUNT; p++) {
+        SchedulePlan plan;
+        if (!buildSchedulePlan(&plan, jobs, count, workers, (SchedulePolicy)p, graph)) {
+            return;
+        }
+        printf("%-10s %10lld s %14.0f s %14lld s\n", policyName(plan.policy),
+               plan.makespan, plan.meanCompletion, plan.highMakespan);
+        freeSchedulePlan(&plan);
+    }
+}
+
+// Ask which scheduling policy to use; an empty line keeps the last one picked
+SchedulePolicy readSchedulePolicy() {
+    printf("\nScheduling policy:\n");
+    printf("1. FIFO (list order)\n");
+    printf("2. Priority (High first)\n");
+    printf("3. SJF - shortest first, lowest mean completion time\n");
+    printf("4. LPT - longest first, shortest makespan\n");
+    printf("5. Weighted - least duration per unit of priority first\n");
+    printf("Choice (Enter for %s): ", policyName(schedulePolicy));
+    char *line = readLine(stdin);
+    if (line != NULL) {
+        int choice = atoi(line);
+        if (choice >= 1 && choice <= SCHEDULE_POLICY_COUNT) {
+            schedulePolicy = (SchedulePolicy)choice;
+        } else if (line[strspn(line, " \t")] != '\0') {
+            printf("Invalid policy. Using %s.\n", policyName(schedulePolicy));
+        }
+        free(line);
+    }
+    return schedulePolicy;
+}
+
+// List the pending tasks and turn the user's selection into jobs, in list
+// order. Returns NULL when nothing was selected.
+ExecutionJob* selectExecutionJobs(int *count) {
+    *count = 0;
+    if (taskCount == 0) {
+        printf("\nNo tasks to execute.\n");
+        return NULL;
+    }
+    
+    // List pending tasks
+    int pendingCount;
+    int *pending = pendingTaskSlots(&pendingCount);
+    if (pending == NULL) {
+        return NULL;
+    }
+    
+    printf("\n=== Pending Tasks ===\n");
+    
+    for (int n = 0; n < pendingCount; n++) {
+        int i = pending[n];
+        printf("%d: %s (%s, %d sec)\n", 
+               taskIds[i], 
+               taskDescription(i), 
+               priorityToString(taskPriorities[i]),
+               taskDurations[i]);
+    }
+    
+    if (pendingCount == 0) {
+        printf("No pending tasks to execute.\n");
+        free(pending);
+        return NULL;
+    }
+    
+    // Task selection
+    bool *selectedTasks = (bool*)calloc(taskSlotCount, sizeof(bool));
+    int numSelected = 0;
+    
+    if (selectedTasks == NULL) {
+        printf("Memory allocation error\n");
+        free(pending);
+        return NULL;
+    }
+    
+    printf("\nSelect tasks to execute (enter IDs separated by commas, or 'all' for all tasks): ");
+    clearInputBuffer();
+    char *taskSelection = readLine(stdin);
+    if (taskSelection == NULL) {
+        free(selectedTasks);
+        free(pending);
+        return NULL;
+    }
+    
+    // Check if user wants all tasks
+    if (strcmp(taskSelection, "all") == 0) {
+        for (int n = 0; n < pendingCount; n++) {
+            selectedTasks[pending[n]] = true;
+        }
+        numSelected = pendingCount;
+    } else {
+        // Parse comma-separated IDs
+        char *token = strtok(taskSelection, " ,");
+        while (token != NULL) {
+            int i = findTaskIndex(atoi(token));
+            if (i >= 0 && !taskCompleted[i] && !selectedTasks[i]) {
+                selectedTasks[i] = true;
+                numSelected++;
+            }
+            token = strtok(NULL, " ,");
+        }
+    }
+    free(taskSelection);
+    free(pending);
+    
+    ExecutionJob *jobs = jobsForSelection(selectedTasks, numSelected, count);
+    free(selectedTasks);
+    return jobs;
+}
+
+// Turn a selection of pending task slots into jobs, in list order, adding the
+// pending prerequisites the selection needs. Returns NULL when nothing was
+// selected.
+ExecutionJob* jobsForSelection(bool *selectedTasks, int numSelected, int *count) {
+    *count = 0;
+    if (numSelected == 0) {
+        printf("No valid tasks selected.\n");
+        return NULL;
+    }
+    
+    // A task cannot run before its prerequisites, so pull pending ones into
+    // the run, and theirs in turn
+    if (dependencyCount > 0) {
+        int *queue = (int*)malloc((size_t)taskSlotCount * sizeof(int));
+        if (queue == NULL) {
+            printf("Memory allocation error\n");
+            return NULL;
+        }
+        int head = 0, tail = 0, added = 0;
+        for (int i = 0; i < taskSlotCount; i++) {
+            if (selectedTasks[i]) {
+                queue[tail++] = i;
+            }
+        }
+        while (head < tail) {
+            int id = taskIds[queue[head++]];
+            for (int e = dependencyLowerBound(id, 0); e < dependencyCount && dependencies[e].task == id; e++) {
+                int i = findTaskIndex(dependencies[e].prerequisite);
+                if (i >= 0 && !taskCompleted[i] && !selectedTasks[i]) {
+                    selectedTasks[i] = true;
+                    queue[tail++] = i;
+                    added++;
+                }
+            }
+        }
+        free(queue);
+        if (added > 0) {
+            printf("Added %d pending prerequisite task(s) to the run.\n", added);
+            numSelected += added;
+        }
+    }
+    
+    ExecutionJob *jobs = (ExecutionJob*)malloc((size_t)numSelected * sizeof(ExecutionJob));
+    if (jobs == NULL) {
+        printf("Memory allocation error\n");
+        return NULL;
+    }
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (selectedTasks[i]) {
+            jobs[*count].task = taskAt(i);
+            jobs[*count].slot = i;
+            (*count)++;
+        }
+    }
+    return jobs;
+}
+
+// Execute the selected pending tasks on the worker pool in the order the
+// chosen policy plans, each starting once its prerequisites are done
+void executeMultipleTasks() {
+    int jobCount;
+    ExecutionJob *jobs = selectExecutionJobs(&jobCount);
+    if (jobs == NULL) {
+        return;
+    }
+    
+    JobGraph graph;
+    if (!buildJobGraph(&graph, jobs, jobCount)) {
+        free(jobs);
+        return;
+    }
+    
+    int workers = readWorkerCount();
+    SchedulePolicy policy = readSchedulePolicy();
+    runJobsOnPool(jobs, jobCount, &graph, workers, policy, true);
+    freeJobGraph(&graph);
+    free(jobs);
+}
+
+// Run jobs on the worker pool, journaling completions as they happen. With
+// confirm set, the plan is shown and the run waits for Enter to start.
+void runJobsOnPool(ExecutionJob *jobs, int jobCount, const JobGraph *graph, int workers, SchedulePolicy policy, bool confirm) {
+    SchedulePlan plan;
+    if (!startExecutor(workers) || !buildSchedulePlan(&plan, jobs, jobCount, executor.workerCount, policy, graph)) {
+        return;
+    }
+    CompletionLog completions;
+    if (!completionLogInit(&completions, jobCount)) {
+        freeSchedulePlan(&plan);
+        return;
+    }
+    
+    if (confirm) {
+        printSchedulePlan(&plan, jobs, graph);
+    }
+    printf("\nExecuting %d tasks on %d worker thread(s), %s order.\n", jobCount, executor.workerCount, policyName(policy));
+    if (confirm) {
+        printf("Once started, Ctrl+C cancels the run and keeps the tasks already completed.\n");
+        printf("Press Enter to start execution or Ctrl+C to cancel...");
+        getchar();
+    }
+    
+    // Completions are journaled in group commits while the run goes on
+    GroupCommit commit;
+    bool committing = startGroupCommit(&commit, &completions, jobs);
+    armCancellation();
+    time_t startTime = time(NULL);
+    executeBatch(jobs, jobCount, &plan, graph, &completions);
+    time_t endTime = time(NULL);
+    disarmCancellation();
+    if (committing) {
+        stopGroupCommit(&commit);
+    }
+    
+    // Apply the published completions to the task store, logging them here
+    // only if the journal thread could not start
+    int completed = atomic_load(&completions.claimed);
+    for (int n = 0; n < completed; n++) {
+        int j = completionLogRead(&completions, n);
+        setTaskCompleted(jobs[j].slot, true);
+        if (!committing) {
+            journalCompletion(jobs[j].slot);
+        }
+    }
+    if (!committing) {
+        journalSync();
+    }
+    checkpointIfNeeded();
+    
+    printf("\n=== Execution Summary ===\n");
+    printf("Tasks completed: %d\n", completed);
+    if (completed < jobCount) {
+        printf("Tasks cancelled: %d (still pending)\n", jobCount - completed);
+    }
+    if (committing) {
+        printf("Journaled as completed in %d group commit(s)%s\n", commit.groups,
+               commit.failed ? ", with errors" : "");
+    }
+    printf("Total wall clock time: %ld seconds (predicted %lld)\n", (endTime - startTime), plan.makespan);
+    if (graph->edgeCount > 0) {
+        printCriticalPath(graph, jobs);
+    }
+    
+    completionLogFree(&completions);
+    freeSchedulePlan(&plan);
+}
+
+// Plan a parallel run without executing it: the chosen policy's timeline,
+// then how every policy would do on the same tasks
+void planParallelRun() {
+    int jobCount;
+    ExecutionJob *jobs = selectExecutionJobs(&jobCount);
+    if (jobs == NULL) {
+        return;
+    }
+    
+    JobGraph graph;
+    if (!buildJobGraph(&graph, jobs, jobCount)) {
+        free(jobs);
+        return;
+    }
+    
+    int workers = readWorkerCount();
+    SchedulePolicy policy = readSchedulePolicy();
+    
+    SchedulePlan plan;
+    if (buildSchedulePlan(&plan, jobs, jobCount, workers, policy, &graph)) {
+        printSchedulePlan(&plan, jobs, &graph);
+        comparePolicies(jobs, jobCount, workers, &graph);
+        freeSchedulePlan(&plan);
+    }
+    freeJobGraph(&graph);
+    free(jobs);
+}
+
+bool timerWheelInit(TimerWheel *wheel, int jobs) {
+    size_t allocated = jobs > 0 ? (size_t)jobs : 1;
+    wheel->now = 0;
+    memset(wheel->heads, -1, sizeof(wheel->heads));
+    wheel->next = (int*)malloc(allocated * sizeof(int));
+    wheel->expires = (long long*)malloc(allocated * sizeof(long long));
+    if (wheel->next == NULL || wheel->expires == NULL) {
+        timerWheelFree(wheel);
+        return false;
+    }
+    return true;
+}
+
+void timerWheelFree(TimerWheel *wheel) {
+    free(wheel->next);
+    free(wheel->expires);
+    wheel->next = NULL;
+    wheel->expires = NULL;
+}
+
+// Put a job's timer in the slot of the lowest level whose span reaches its
+// expiry. A timer beyond the top level's span waits in its furthest slot and
+// is placed again when that slot cascades.
+void timerWheelAdd(TimerWheel *wheel, int job, long long expires) {
+    const long long span = 1LL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS);
+    long long delta = expires - wheel->now;
+    if (delta >= span) {
+        delta = span - 1;
+    }
+    int level = 0;
+    while (delta >= 1LL << (TIMER_WHEEL_BITS * (level + 1))) {
+        level++;
+    }
+    long long target = wheel->now + delta;
+    int slot = (int)((target >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+    wheel->expires[job] = expires;
+    wheel->next[job] = wheel->heads[level][slot];
+    wheel->heads[level][slot] = job;
+}
+
+// Move the timers of a level's current slot down to the levels below
+void timerWheelCascade(TimerWheel *wheel, int level) {
+    int slot = (int)((wheel->now >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+    int job = wheel->heads[level][slot];
+    wheel->heads[level][slot] = -1;
+    while (job >= 0) {
+        int following = wheel->next[job];
+        timerWheelAdd(wheel, job, wheel->expires[job]);
+        job = following;
+    }
+}
+
+// Advance one tick and detach the timers firing on it. Returns the first
+// job of their list, linked through next[], or -1 if none fire.
+int timerWheelAdvance(TimerWheel *wheel) {
+    wheel->now++;
+    for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+        if ((wheel->now & ((1LL << (TIMER_WHEEL_BITS * level)) - 1)) != 0) {
+            break;
+        }
+        timerWheelCascade(wheel, level);
+    }
+    int slot = (int)(wheel->now & (TIMER_WHEEL_SLOTS - 1));
+    int fired = wheel->heads[0][slot];
+    wheel->heads[0][slot] = -1;
+    return fired;
+}
+
+// Run a batch on a timer wheel from the calling thread, up to `slots` jobs at
+// once. Each tick fires the timers of the jobs finishing on it, releases the
+// jobs that waited on them and starts ready jobs in policy order in the freed
+// slots, so every job starts and finishes on the tick buildSchedulePlan()
+// predicts for `slots` workers. A tick lasts tickMicros of wall-clock time,
+// or no time at all when 0. A cancel stops the run at the next tick. Returns
+// the makespan in ticks, or -1 when out of memory.
+long long runTimerEngine(const ExecutionJob *jobs, int count, int slots, SchedulePolicy policy,
+                         const JobGraph *graph, long long tickMicros, TimerEvent onEvent) {
+    bool dependent = graph != NULL && graph->edgeCount > 0;
+    size_t allocated = count > 0 ? (size_t)count : 1;
+    PlanKey *keys = (PlanKey*)malloc(allocated * sizeof(PlanKey));
+    TimedEntry *ready = (TimedEntry*)malloc(allocated * sizeof(TimedEntry));
+    int *rank = dependent ? (int*)malloc(allocated * sizeof(int)) : NULL;
+    int *waiting = dependent ? (int*)malloc(allocated * sizeof(int)) : NULL;
+    TimerWheel wheel;
+    bool wheelReady = timerWheelInit(&wheel, count);
+    if (keys == NULL || ready == NULL || (dependent && (rank == NULL || waiting == NULL)) || !wheelReady) {
+        printf("Memory allocation error\n");
+        free(keys);
+        free(ready);
+        free(rank);
+        free(waiting);
+        if (wheelReady) {
+            timerWheelFree(&wheel);
+        }
+        return -1;
+    }
+    
+    for (int j = 0; j < count; j++) {
+        keys[j].key = policySortKey(&jobs[j].task, policy);
+        keys[j].job = j;
+    }
+    if (policy != POLICY_FIFO) {
+        qsort(keys, count, sizeof(PlanKey), comparePlanKeys);
+    }
+    
+    // Ready jobs keyed by rank; added in rank order, so already a valid heap
+    int readyCount = 0;
+    for (int k = 0; k < count; k++) {
+        int j = keys[k].job;
+        if (dependent) {
+            rank[j] = k;
+            waiting[j] = graph->predecessorCount[j];
+            if (waiting[j] > 0) {
+                continue;
+            }
+        }
+        ready[readyCount].time = k;
+        ready[readyCount].id = j;
+        readyCount++;
+    }
+    free(keys);
+    
+    double start = monotonicSeconds();
+    long long makespan = 0;
+    int running = 0;
+    for (;;) {
+        while (running < slots && readyCount > 0) {
+            int j = ready[0].id;
+            ready[0] = ready[--readyCount];
+            siftDownTimed(ready, readyCount, 0);
+            
+            // A zero-length job still takes a tick; the current one is already spent
+            long long duration = jobs[j].task.duration > 0 ? jobs[j].task.duration : 1;
+            timerWheelAdd(&wheel, j, wheel.now + duration);
+            running++;
+            if (onEvent != NULL) {
+                onEvent(jobs, j, wheel.now, false);
+            }
+        }
+        if (running == 0) {
+            break;   // all done, or only a cycle leaves jobs waiting
+        }
+        if (cancelRequested(&executionCancel)) {
+            break;   // jobs still running are left unfinished
+        }
+        
+        // Sleep to the next tick's deadline on the run's own clock, so ticks don't drift
+        if (tickMicros > 0) {
+            long long wait = (wheel.now + 1) * tickMicros - (long long)((monotonicSeconds() - start) * 1e6);
+            if (wait > 0) {
+                sleepMicroseconds(wait);
+            }
+        }
+        
+        int j = timerWheelAdvance(&wheel);
+        while (j >= 0) {
+            int following = wheel.next[j];
+            running--;
+            makespan = wheel.now;
+            if (onEvent != NULL) {
+                onEvent(jobs, j, wheel.now, true);
+            }
+            if (dependent) {
+                for (int k = graph->successorStart[j]; k < graph->successorStart[j + 1]; k++) {
+                    int s = graph->successors[k];
+                    if (--waiting[s] == 0) {
+                        ready[readyCount].time = rank[s];
+                        ready[readyCount].id = s;
+                        siftUpTimed(ready, readyCount++);
+                    }
+                }
+            }
+            j = following;
+        }
+    }
+    
+    free(ready);
+    free(rank);
+    free(waiting);
+    timerWheelFree(&wheel);
+    return makespan;
+}
+
+// Timer engine events of an interactive run: a line per start and per
+// completion, and each completion marked in the task store and published
+// for the journal
+void printTimerEvent(const ExecutionJob *jobs, int job, long long tick, bool finished) {
+    const Task *task = &jobs[job].task;
+    if (finished) {
+        setTaskCompleted(jobs[job].slot, true);
+        if (timerCompletions != NULL) {
+            completionLogPublish(timerCompletions, job);
+        }
+        printf("[%6lld s] Task %d completed!\n", tick, task->id);
+    } else {
+        printf("[%6lld s] Executing: %s (ID: %d) | Priority: %s | Duration: %d sec\n",
+               tick, task->description, task->id, priorityToString(task->priority), task->duration);
+    }
+}
+
+// Ask how many tasks may run at once on the timer wheel; an empty line runs them all together
+int readTimerSlots(int count) {
+    int slots = count < MAX_TIMER_SLOTS ? count : MAX_TIMER_SLOTS;
+    printf("Tasks running at once (1-%d, Enter for %d): ", MAX_TIMER_SLOTS, slots);
+    char *line = readLine(stdin);
+    if (line != NULL) {
+        int requested = atoi(line);
+        if (requested >= 1 && requested <= MAX_TIMER_SLOTS) {
+            slots = requested < count ? requested : count;
+        } else if (line[strspn(line, " \t")] != '\0') {
+            printf("Invalid count. Using %d.\n", slots);
+        }
+        free(line);
+    }
+    return slots;
+}
+
+// Execute the selected pending tasks on the timer wheel: one thread counts
+// down any number of running tasks, started in the chosen policy's order
+void executeOnTimerWheel() {
+    int jobCount;
+    ExecutionJob *jobs = selectExecutionJobs(&jobCount);
+    if (jobs == NULL) {
+        return;
+    }
+    
+    JobGraph graph;
+    if (!buildJobGraph(&graph, jobs, jobCount)) {
+        free(jobs);
+        return;
+    }
+    
+    int slots = readTimerSlots(jobCount);
+    SchedulePolicy policy = readSchedulePolicy();
+    SchedulePlan plan;
+    if (!buildSchedulePlan(&plan, jobs, jobCount, slots, policy, &graph)) {
+        freeJobGraph(&graph);
+        free(jobs);
+        return;
+    }
+    long long predicted = plan.makespan;
+    freeSchedulePlan(&plan);
+    CompletionLog completions;
+    if (!completionLogInit(&completions, jobCount)) {
+        freeJobGraph(&graph);
+        free(jobs);
+        return;
+    }
+    
+    printf("\nExecuting %d tasks on the timer wheel, up to %d at once, %s order.\n", jobCount, slots, policyName(policy));
+    printf("Predicted total time: %lld seconds\n", predicted);
+    if (graph.edgeCount > 0) {
+        printCriticalPath(&graph, jobs);
+    }
+    printf("Once started, Ctrl+C cancels the run and keeps the tasks already completed.\n");
+    printf("Press Enter to start execution or Ctrl+C to cancel...");
+    getchar();
+    printf("\n");
+    
+    // Completions are journaled in group commits while the run goes on
+    GroupCommit commit;
+    bool committing = startGroupCommit(&commit, &completions, jobs);
+    timerCompletions = &completions;
+    armCancellation();
+    time_t startTime = time(NULL);
+    long long makespan = runTimerEngine(jobs, jobCount, slots, policy, &graph, 1000000, printTimerEvent);
+    time_t endTime = time(NULL);
+    disarmCancellation();
+    timerCompletions = NULL;
+    if (committing) {
+        stopGroupCommit(&commit);
+    }
+    
+    int completed = atomic_load(&completions.claimed);
+    if (!committing) {
+        for (int n = 0; n < completed; n++) {
+            journalCompletion(jobs[completionLogRead(&completions, n)].slot);
+        }
+        journalSync();
+    }
+    checkpointIfNeeded();
+    
+    if (makespan >= 0) {
+        printf("\n=== Execution Summary ===\n");
+        printf("Tasks completed: %d\n", completed);
+        if (completed < jobCount) {
+            printf("Tasks cancelled: %d (still pending)\n", jobCount - completed);
+        }
+        if (committing) {
+            printf("Journaled as completed in %d group commit(s)%s\n", commit.groups,
+                   commit.failed ? ", with errors" : "");
+        }
+        printf("Total wall clock time: %ld seconds (predicted %lld)\n", (endTime - startTime), predicted);
+    }
+    
+    completionLogFree(&completions);
+    freeJobGraph(&graph);
+    free(jobs);
+}
+
+// Job indexes of a plan in the order they finish; jobs finishing together
+// keep the order they started in. O(n log n).
+int* completionOrder(const SchedulePlan *plan, const ExecutionJob *jobs) {
+    size_t allocated = plan->count > 0 ? (size_t)plan->count : 1;
+    PlanKey *keys = (PlanKey*)malloc(allocated * sizeof(PlanKey));
+    int *order = (int*)malloc(allocated * sizeof(int));
+    if (keys == NULL || order == NULL) {
+        printf("Memory allocation error\n");
+        free(keys);
+        free(order);
+        return NULL;
+    }
+    for (int k = 0; k < plan->count; k++) {
+        int j = plan->order[k];
+        keys[k].key = plan->start[j] + jobs[j].task.duration;
+        keys[k].job = k;
+    }
+    qsort(keys, plan->count, sizeof(PlanKey), comparePlanKeys);
+    for (int k = 0; k < plan->count; k++) {
+        order[k] = plan->order[keys[k].job];
+    }
+    free(keys);
+    return order;
+}
+
+// Totals of a simulated run and its first completions, as a real run would log them
+void printSimulation(const SchedulePlan *plan, const ExecutionJob *jobs, const int *completed, double elapsed) {
+    printf("\n=== Simulated Run: %s, %d tasks on %d worker(s) ===\n", policyName(plan->policy), plan->count,
+           plan->workers);
+    printf("Total time: %lld seconds | mean completion: %.0f seconds", plan->makespan, plan->meanCompletion);
+    if (plan->highMakespan > 0) {
+        printf(" | last High done: %lld seconds", plan->highMakespan);
+    }
+    printf("\nSimulated in %.2f ms (%.0f completions per second)\n", elapsed * 1e3,
+           elapsed > 0 ? plan->count / elapsed : 0.0);
+    
+    int shown = plan->count < SIMULATION_EVENT_PREVIEW ? plan->count : SIMULATION_EVENT_PREVIEW;
+    printf("\n%-6s %8s %7s %10s %10s  %s\n", "Done", "ID", "Worker", "Start", "Finish", "Description");
+    for (int k = 0; k < shown; k++) {
+        int j = completed[k];
+        printf("%-6d %8d %7d %10lld %10lld  %s\n", k + 1, jobs[j].task.id, plan->worker[j] + 1, plan->start[j],
+               plan->start[j] + jobs[j].task.duration, jobs[j].task.description);
+    }
+    if (plan->count > shown) {
+        printf("... (%d more)\n", plan->count - shown);
+    }
+}
+
+// Write a simulated run as CSV, one task per line in completion order
+bool writeSimulationTimeline(const char *path, const SchedulePlan *plan, const ExecutionJob *jobs,
+                             const int *completed) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        printf("Error: Cannot open %s for writing.\n", path);
+        return false;
+    }
+    fprintf(file, "id,worker,priority,duration,start,finish\n");
+    for (int k = 0; k < plan->count; k++) {
+        int j = completed[k];
+        fprintf(file, "%d,%d,%s,%d,%lld,%lld\n", jobs[j].task.id, plan->worker[j] + 1,
+                priorityToString(jobs[j].task.priority), jobs[j].task.duration, plan->start[j],
+                plan->start[j] + jobs[j].task.duration);
+    }
+    bool written = fclose(file) == 0;
+    if (!written) {
+        printf("Error: Cannot write %s.\n", path);
+    }
+    return written;
+}
+
+// Capacity plan: the same run simulated on 1, 2, 4, ... workers, up to the
+// pool's limit or until more workers no longer shorten it
+void sweepWorkerCounts(const ExecutionJob *jobs, int count, SchedulePolicy policy, const JobGraph *graph) {
+    long long totalDuration = 0;
+    for (int j = 0; j < count; j++) {
+        totalDuration += jobs[j].task.duration;
+    }
+    
+    printf("\n%-8s %12s %16s %12s\n", "Workers", "Total time", "Mean completion", "Utilization");
+    long long previous = -1;
+    for (int workers = 1; workers <= MAX_EXECUTOR_WORKERS; workers *= 2) {
+        SchedulePlan plan;
+        if (!buildSchedulePlan(&plan, jobs, count, workers, policy, graph)) {
+            return;
+        }
+        long long makespan = plan.makespan;
+        printf("%-8d %10lld s %14.0f s %11.1f%%\n", workers, makespan, plan.meanCompletion,
+               makespan > 0 ? 100.0 * totalDuration / ((double)workers * makespan) : 100.0);
+        freeSchedulePlan(&plan);
+        if (makespan == previous || workers >= count) {
+            printf("More workers do not shorten the run.\n");
+            return;
+        }
+        previous = makespan;
+    }
+}
+
+// Simulate a parallel run in virtual time: no waiting, and no task marked
+// completed. Shows each task's start and finish as a real run would have
+// them, then how the run scales with the number of workers.
+void simulateRun() {
+    int jobCount;
+    ExecutionJob *jobs = selectExecutionJobs(&jobCount);
+    if (jobs == NULL) {
+        return;
+    }
+    
+    JobGraph graph;
+    if (!buildJobGraph(&graph, jobs, jobCount)) {
+        free(jobs);
+        return;
+    }
+    
+    int workers = readWorkerCount();
+    SchedulePolicy policy = readSchedulePolicy();
+    
+    double start = monotonicSeconds();
+    SchedulePlan plan;
+    if (!buildSchedulePlan(&plan, jobs, jobCount, workers, policy, &graph)) {
+        freeJobGraph(&graph);
+        free(jobs);
+        return;
+    }
+    int *completed = completionOrder(&plan, jobs);
+    double elapsed = monotonicSeconds() - start;
+    
+    if (completed != NULL) {
+        printSimulation(&plan, jobs, completed, elapsed);
+        if (graph.edgeCount > 0) {
+            printCriticalPath(&graph, jobs);
+        }
+        sweepWorkerCounts(jobs, jobCount, policy, &graph);
+        
+        printf("\nWrite every task's start and finish to a CSV file (Enter to skip): ");
+        char *path = readLine(stdin);
+        if (path != NULL) {
+            if (path[0] != '\0' && writeSimulationTimeline(path, &plan, jobs, completed)) {
+                printf("Timeline written to %s.\n", path);
+            }
+            free(path);
+        }
+        free(completed);
+    }
+    
+    freeSchedulePlan(&plan);
+    freeJobGraph(&graph);
+    free(jobs);
+}
+
+// Execute a specific task
+void executeSpecificTask() {
+    if (taskCount == 0) {
+        printf("\nNo tasks available to execute.\n");
+        return;
+    }
+    
+    printf("\n=== Execute Specific Task ===\n");
+    
+    // Display only pending tasks
+    printf("Pending tasks:\n");
+    int pendingCount;
+    int *pending = pendingTaskSlots(&pendingCount);
+    if (pending == NULL) {
+        return;
+    }
+    for (int n = 0; n < pendingCount; n++) {
+        int i = pending[n];
+        printf("%d: %s (%s, %d sec)\n", 
+               taskIds[i], 
+               taskDescription(i), 
+               priorityToString(taskPriorities[i]),
+               taskDurations[i]);
+    }
+    free(pending);
+    
+    if (pendingCount == 0) {
+        printf("No pending tasks to execute.\n");
+        return;
+    }
+    
+    printf("\nEnter task ID to execute (or 0 to cancel): ");
+    int id;
+    scanf("%d", &id);
+    
+    if (id == 0) return;
+    
+    // Find and execute the task
+    int i = findTaskIndex(id);
+    if (i < 0) {
+        printf("Task with ID %d not found.\n", id);
+        return;
+    }
+    if (taskCompleted[i]) {
+        printf("Task %d is already marked as completed.\n", id);
+        return;
+    }
+    char waiting[128];
+    if (formatPrerequisites(id, true, waiting, sizeof(waiting)) > 0) {
+        printf("Task %d is waiting on task(s) %s. Run those first.\n", id, waiting);
+        return;
+    }
+    
+    printf("\nExecuting: %s (ID: %d) | Priority: %s | Duration: %d sec\n",
+           taskDescription(i), taskIds[i], 
+           priorityToString(taskPriorities[i]), 
+           taskDurations[i]);
+    
+    printf("Press Enter to start execution...");
+    clearInputBuffer();
+    getchar();
+    
+    // Countdown timer
+    for (int j = taskDurations[i]; j > 0; j--) {
+        printf("\rTime remaining: %d seconds...   ", j);
+        fflush(stdout);
+        sleep(1);  // Simulate execution
+    }
+    
+    setTaskCompleted(i, true);
+    printf("\rTask %d completed!                  \n", taskIds[i]);
+    journalCompletion(i);
+    journalSync();
+    checkpointIfNeeded();
+}
+
+// Execute all pending tasks in order
+void executeTasks() {
+    printf("\n=== Execute Tasks ===\n");
+    printf("1. Execute all tasks in sequence\n");
+    printf("2. Execute multiple tasks simultaneously\n");
+    printf("3. Execute a specific task\n");
+    printf("4. Return to main menu\n");
+    printf("5. Plan a parallel run (no execution)\n");
+    printf("6. Execute many tasks at once on a timer wheel\n");
+    printf("7. Simulate a parallel run in virtual time (no waiting)\n");
+    printf("Choice: ");
+    
     int choice;
     scanf("%d", &choice);
     
-    switch (choice) {
-        case 1: {
-            char keyword[50];
-            clearInputBuffer();
-            printf("Enter keyword: ");
-            fgets(keyword, sizeof(keyword), stdin);
-            keyword[strcspn(keyword, "\n")] = 0;
-            
-            printf("\n=== Search Results ===\n");
-            int found = 0;
-            
-            for (int i = 0; i < taskCount; i++) {
-                if (strstr(tasks[i].description, keyword) != NULL) {
-                    displayTaskDetails(tasks[i]);
-                    found++;
-                }
+    switch (choice) {
+        case 1: {
+            if (taskCount == 0) {
+                printf("\nNo tasks to execute.\n");
+                return;
+            }
+            
+            // Sort the pending tasks by priority, leaving the task list in its current order.
+            // pendingTaskSlots() builds the indexes a load left for later, so its count
+            // is the one to trust.
+            int orderCount;
+            int *order = pendingTaskSlots(&orderCount);
+            if (order == NULL) {
+                return;
+            }
+            if (orderCount == 0) {
+                printf("\nNo pending tasks to execute.\n");
+                free(order);
+                return;
+            }
+            sortTaskSlots(order, orderCount, SORT_BY_PRIORITY, processorCount());
+            
+            // Planning that order on one worker holds each task back until its
+            // prerequisites have run
+            ExecutionJob *jobs = (ExecutionJob*)malloc((size_t)orderCount * sizeof(ExecutionJob) + 1);
+            if (jobs == NULL) {
+                printf("Memory allocation error\n");
+                free(order);
+                return;
+            }
+            for (int n = 0; n < orderCount; n++) {
+                jobs[n].task = taskAt(order[n]);
+                jobs[n].slot = order[n];
+            }
+            JobGraph graph;
+            SchedulePlan plan;
+            if (!buildJobGraph(&graph, jobs, orderCount)) {
+                free(jobs);
+                free(order);
+                return;
+            }
+            if (!buildSchedulePlan(&plan, jobs, orderCount, 1, POLICY_FIFO, &graph)) {
+                freeJobGraph(&graph);
+                free(jobs);
+                free(order);
+                return;
+            }
+            for (int n = 0; n < orderCount; n++) {
+                order[n] = jobs[plan.order[n]].slot;
+            }
+            freeSchedulePlan(&plan);
+            freeJobGraph(&graph);
+            free(jobs);
+
+            printf("\n=== Executing %d Pending Tasks in Sequence ===\n", orderCount);
+            printf("Tasks will be executed in priority order (highest first), each after its prerequisites.\n");
+            
+            // Calculate total estimated time
+            long long totalTime = 0;
+            for (int n = 0; n < orderCount; n++) {
+                totalTime += taskDurations[order[n]];
+            }
+            printf("Total estimated time: %lld seconds\n\n", totalTime);
+            
+            printf("Press Enter to start execution or Ctrl+C to cancel...");
+            clearInputBuffer();
+            getchar();
+            
+            int executed = 0;
+            time_t startTime = time(NULL);
+            
+            for (int n = 0; n < orderCount; n++) {
+                int i = order[n];
+                if (!taskCompleted[i]) {
+                    printf("\n[%d/%d] Executing: %s (ID: %d) | Priority: %s | Duration: %d sec\n",
+                           executed + 1, orderCount, taskDescription(i), taskIds[i], 
+                           priorityToString(taskPriorities[i]), taskDurations[i]);
+                    
+                    // Countdown timer
+                    for (int j = taskDurations[i]; j > 0; j--) {
+                        printf("\rTime remaining: %d seconds...   ", j);
+                        fflush(stdout);
+                        sleep(1);  // Simulate execution
+                    }
+                    
+                    setTaskCompleted(i, true);
+                    executed++;
+                    printf("\rTask %d completed!                  \n", taskIds[i]);
+                    journalCompletion(i);
+                    journalSync();
+                }
+            }
+            
+            free(order);
+            
+            time_t endTime = time(NULL);
+            printf("\n=== Execution Summary ===\n");
+            printf("Tasks completed: %d\n", executed);
+            printf("Total wall clock time: %ld seconds\n", (endTime - startTime));
+            
+            checkpointIfNeeded();
+            break;
+        }
+        case 2:
+            executeMultipleTasks();
+            break;
+        case 3:
+            executeSpecificTask();
+            break;
+        case 4:
+            return;
+        case 5:
+            planParallelRun();
+            break;
+        case 6:
+            executeOnTimerWheel();
+            break;
+        case 7:
+            simulateRun();
+            break;
+        default:
+            printf("Invalid choice.\n");
+    }
+}
+
+bool sameWordIgnoreCase(const char *text, const char *word) {
+    size_t length = strlen(word);
+    return strlen(text) == length && equalsIgnoreCase(text, word, length);
+}
+
+// Priority from a command-line word: high, medium or low (any case), or the
+// menu's numbers 1-3
+bool parsePriorityName(const char *text, Priority *priority) {
+    if (sameWordIgnoreCase(text, "high") || strcmp(text, "1") == 0) {
+        *priority = HIGH;
+    } else if (sameWordIgnoreCase(text, "medium") || strcmp(text, "2") == 0) {
+        *priority = MEDIUM;
+    } else if (sameWordIgnoreCase(text, "low") || strcmp(text, "3") == 0) {
+        *priority = LOW;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Scheduling policy from its name (fifo, priority, sjf, lpt, weighted) or menu number
+bool parsePolicyName(const char *text, SchedulePolicy *policy) {
+    for (int p = 1; p <= SCHEDULE_POLICY_COUNT; p++) {
+        if (sameWordIgnoreCase(text, policyName((SchedulePolicy)p)) || atoi(text) == p) {
+            *policy = (SchedulePolicy)p;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Parse one "PRIORITY DURATION DESCRIPTION" record into t, in place, leaving
+// the ID and created time to be assigned. Returns why the record was
+// rejected, or NULL. Descriptions are cut to fit, as the interactive prompt does.
+const char* parseTaskRecord(char *line, Task *t) {
+    t->id = 0;
+    t->created = 0;
+    t->completed = false;
+    char *cursor = line + strspn(line, " \t");
+    char *word = cursor;
+    cursor += strcspn(cursor, " \t\r\n");
+    if (*cursor == '\0' || *cursor == '\r' || *cursor == '\n') {
+        return "expected PRIORITY DURATION DESCRIPTION";
+    }
+    *cursor++ = '\0';
+    if (!parsePriorityName(word, &t->priority)) {
+        return "priority must be high, medium, low or 1-3";
+    }
+    
+    char *end;
+    long duration = strtol(cursor, &end, 10);
+    if (end == cursor || (*end != ' ' && *end != '\t')) {
+        return "expected PRIORITY DURATION DESCRIPTION";
+    }
+    if (duration < 1 || duration > 3600) {
+        return "duration must be between 1 and 3600 seconds";
+    }
+    t->duration = (int)duration;
+    
+    cursor = end + strspn(end, " \t");
+    size_t length = strcspn(cursor, "\r\n");
+    while (length > 0 && isspace((unsigned char)cursor[length - 1])) {
+        length--;
+    }
+    if (length == 0) {
+        return "description is empty";
+    }
+    if (length >= MAX_DESCRIPTION) {
+        length = MAX_DESCRIPTION - 1;
+    }
+    memcpy(t->description, cursor, length);
+    t->description[length] = '\0';
+    return NULL;
+}
+
+// Add a parsed record as a new task and journal it without syncing. The
+// record keeps its ID if no task has ever had it, else gets the next one,
+// since dependency edges outlive deleted tasks and must not pass to a
+// stranger. A record without a created time is stamped now. A duplicate
+// is skipped (added left false) unless keepDuplicates is set. Returns false
+// if the task could not be stored or logged.
+bool addTaskRecord(Task *t, bool keepDuplicates, bool *added) {
+    *added = false;
+    if (!keepDuplicates && findDuplicateTask(t->description, t->priority, t->duration) >= 0) {
+        return true;
+    }
+    
+    // setRecordField() keeps IDs below INT_MAX, so the one after always fits
+    if (t->id < nextTaskId) {
+        t->id = claimTaskId();
+        if (t->id == 0) {
+            return false;
+        }
+    } else {
+        nextTaskId = t->id + 1;
+    }
+    if (t->created == 0) {
+        t->created = time(NULL);
+    }
+    if (!appendTask(t)) {
+        printf("Task could not be added.\n");
+        return false;
+    }
+    *added = true;
+    int slot = findTaskIndex(t->id);
+    return slot >= 0 && journalTaskRecord(JOURNAL_ADD, slot);
+}
+
+// Format from its name (text, csv, jsonl) for --format
+bool parseRecordFormat(const char *name, RecordFormat *format) {
+    for (int f = 0; f < RECORD_FORMAT_COUNT; f++) {
+        if (sameWordIgnoreCase(name, recordFormatNames[f])) {
+            *format = (RecordFormat)f;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Format implied by a file's extension, or the fallback
+RecordFormat formatForPath(const char *path, RecordFormat fallback) {
+    const char *dot = strrchr(path, '.');
+    if (dot == NULL) {
+        return fallback;
+    }
+    if (sameWordIgnoreCase(dot, ".csv")) {
+        return FORMAT_CSV;
+    }
+    if (sameWordIgnoreCase(dot, ".jsonl") || sameWordIgnoreCase(dot, ".ndjson") || sameWordIgnoreCase(dot, ".json")) {
+        return FORMAT_JSONL;
+    }
+    if (sameWordIgnoreCase(dot, ".txt")) {
+        return FORMAT_TEXT;
+    }
+    return fallback;
+}
+
+bool readerInit(RecordReader *reader, FILE *file) {
+    reader->buffer = (unsigned char*)malloc(STREAM_BUFFER_SIZE);
+    if (reader->buffer == NULL) {
+        printf("Memory allocation error\n");
+        return false;
+    }
+    reader->file = file;
+    reader->length = 0;
+    reader->position = 0;
+    reader->line = 1;
+    reader->recordLine = 1;
+    reader->columnCount = 0;
+    reader->headerRead = false;
+    return true;
+}
+
+void readerFree(RecordReader *reader) {
+    free(reader->buffer);
+    reader->buffer = NULL;
+}
+
+// Next byte without consuming it, refilling the buffer from the file as needed
+int readerPeek(RecordReader *reader) {
+    if (reader->position == reader->length) {
+        reader->length = fread(reader->buffer, 1, STREAM_BUFFER_SIZE, reader->file);
+        reader->position = 0;
+        if (reader->length == 0) {
+            return EOF;
+        }
+    }
+    return reader->buffer[reader->position];
+}
+
+int readerNext(RecordReader *reader) {
+    int c = readerPeek(reader);
+    if (c != EOF) {
+        reader->position++;
+        if (c == '\n') {
+            reader->line++;
+        }
+    }
+    return c;
+}
+
+// Copy bytes into value (cut to fit) up to the next stopA, stopB or newline,
+// leaving that byte unread: the fast path of every field and string read
+void readerCopyUntil(RecordReader *reader, int stopA, int stopB, char *value, size_t size, size_t *length) {
+    while (readerPeek(reader) != EOF) {
+        const unsigned char *start = reader->buffer + reader->position;
+        const unsigned char *end = reader->buffer + reader->length;
+        const unsigned char *p = start;
+        while (p < end && *p != stopA && *p != stopB && *p != '\n') {
+            p++;
+        }
+        size_t n = (size_t)(p - start);
+        size_t kept = n < size - 1 - *length ? n : size - 1 - *length;
+        memcpy(value + *length, start, kept);
+        *length += kept;
+        reader->position += n;
+        if (p < end) {
+            return;
+        }
+    }
+}
+
+void readerSkipLine(RecordReader *reader) {
+    int c;
+    while ((c = readerNext(reader)) != EOF && c != '\n');
+}
+
+// Field of a CSV header or JSON key by name; FIELD_IGNORED for unknown ones
+RecordField recordFieldByName(const char *name) {
+    for (int f = 0; f < FIELD_IGNORED; f++) {
+        if (sameWordIgnoreCase(name, recordFieldNames[f])) {
+            return (RecordField)f;
+        }
+    }
+    return FIELD_IGNORED;
+}
+
+// Set one field of a task read from CSV or JSON; returns why the value was
+// rejected, or NULL. An empty id or created time leaves it to be assigned.
+const char* setRecordField(Task *t, RecordField field, const char *value, unsigned int *seen) {
+    char *end;
+    long long number = 0;
+    if (field == FIELD_ID || field == FIELD_DURATION || field == FIELD_CREATED) {
+        if (*value == '\0' && field != FIELD_DURATION) {
+            return NULL;
+        }
+        number = strtoll(value, &end, 10);
+        if (end == value || *end != '\0') {
+            return field == FIELD_ID ? "invalid id" : field == FIELD_DURATION ? "invalid duration" : "invalid created time";
+        }
+    }
+    
+    switch (field) {
+        case FIELD_ID:
+            if (number < 0 || number >= INT_MAX) {
+                return "invalid id";
             }
-            
-            if (found == 0) {
-                printf("No tasks found matching '%s'\n", keyword);
+            t->id = (int)number;
+            break;
+        case FIELD_DESCRIPTION: {
+            // Descriptions are single lines, as the prompts read them
+            size_t length = strnlen(value, MAX_DESCRIPTION - 1);
+            for (size_t k = 0; k < length; k++) {
+                t->description[k] = value[k] == '\n' || value[k] == '\r' ? ' ' : value[k];
+            }
+            t->description[length] = '\0';
+            break;
+        }
+        case FIELD_PRIORITY:
+            if (!parsePriorityName(value, &t->priority)) {
+                return "priority must be high, medium, low or 1-3";
+            }
+            break;
+        case FIELD_DURATION:
+            if (number < 1 || number > 3600) {
+                return "duration must be between 1 and 3600 seconds";
+            }
+            t->duration = (int)number;
+            break;
+        case FIELD_CREATED:
+            t->created = (time_t)number;
+            break;
+        case FIELD_COMPLETED:
+            if (sameWordIgnoreCase(value, "true") || strcmp(value, "1") == 0) {
+                t->completed = true;
+            } else if (sameWordIgnoreCase(value, "false") || strcmp(value, "0") == 0 || *value == '\0') {
+                t->completed = false;
             } else {
-                printf("%d task(s) found.\n", found);
+                return "completed must be true or false";
+            }
+            break;
+        default:
+            return NULL;
+    }
+    *seen |= 1u << field;
+    return NULL;
+}
+
+// A record must at least say what the task is and how to run it
+const char* checkRecordFields(const Task *t, unsigned int seen) {
+    unsigned int required = (1u << FIELD_DESCRIPTION) | (1u << FIELD_PRIORITY) | (1u << FIELD_DURATION);
+    if ((seen & required) != required) {
+        return "description, priority and duration are required";
+    }
+    if (t->description[strspn(t->description, " \t")] == '\0') {
+        return "description is empty";
+    }
+    return NULL;
+}
+
+// Read one CSV field into value, cut to fit. Returns what ended it: ',' or
+// '\n' (also for the end of the input), or 0 when a quoted field is malformed.
+int readCsvField(RecordReader *reader, char *value, size_t size) {
+    size_t length = 0;
+    int c;
+    if (readerPeek(reader) == '"') {
+        readerNext(reader);
+        for (;;) {
+            readerCopyUntil(reader, '"', '"', value, size, &length);
+            c = readerNext(reader);
+            if (c == EOF) {
+                value[length] = '\0';
+                return 0;
+            }
+            if (c == '"') {
+                if (readerPeek(reader) != '"') {
+                    break;
+                }
+                readerNext(reader);
+            }
+            if (length < size - 1) {
+                value[length++] = (char)c;
+            }
+        }
+        c = readerNext(reader);
+        if (c == '\r') {
+            c = readerNext(reader);
+        }
+        value[length] = '\0';
+        return c == ',' ? ',' : c == '\n' || c == EOF ? '\n' : 0;
+    }
+    
+    // Unquoted: carriage returns are dropped
+    do {
+        readerCopyUntil(reader, ',', '\r', value, size, &length);
+        c = readerNext(reader);
+    } while (c == '\r');
+    value[length] = '\0';
+    return c == ',' ? ',' : '\n';
+}
+
+// Map the columns of the header row to task fields
+bool readCsvHeader(RecordReader *reader) {
+    char name[CSV_HEADER_NAME_MAX];
+    int ended;
+    do {
+        ended = readCsvField(reader, name, sizeof(name));
+        if (reader->columnCount < CSV_MAX_COLUMNS) {
+            reader->columns[reader->columnCount++] = recordFieldByName(name);
+        }
+    } while (ended == ',');
+    reader->headerRead = true;
+    return ended != 0;
+}
+
+// Read the next CSV record into t. Returns 1 for a record, 0 at the end of
+// the input, or -1 with *error set for a record that was rejected.
+int nextCsvRecord(RecordReader *reader, Task *t, const char **error) {
+    if (!reader->headerRead && !readCsvHeader(reader)) {
+        *error = "malformed header row";
+        return -1;
+    }
+    while (readerPeek(reader) == '\n' || readerPeek(reader) == '\r') {
+        readerNext(reader);
+    }
+    if (readerPeek(reader) == EOF) {
+        return 0;
+    }
+    
+    memset(t, 0, sizeof(*t));
+    reader->recordLine = reader->line;
+    char value[MAX_DESCRIPTION];
+    unsigned int seen = 0;
+    int column = 0, ended;
+    *error = NULL;
+    do {
+        ended = readCsvField(reader, value, sizeof(value));
+        if (ended == 0) {
+            *error = "malformed quoted field";
+            readerSkipLine(reader);
+            return -1;
+        }
+        if (*error == NULL && column < reader->columnCount) {
+            *error = setRecordField(t, reader->columns[column], value, &seen);
+        }
+        column++;
+    } while (ended == ',');
+    
+    if (*error == NULL) {
+        *error = checkRecordFields(t, seen);
+    }
+    return *error == NULL ? 1 : -1;
+}
+
+void skipJsonSpace(RecordReader *reader) {
+    int c = readerPeek(reader);
+    while (c == ' ' || c == '\t' || c == '\r') {
+        readerNext(reader);
+        c = readerPeek(reader);
+    }
+}
+
+// Append a code point to value as UTF-8, if it fits
+void putUtf8(char *value, size_t size, size_t *length, unsigned int code) {
+    char bytes[4];
+    int n;
+    if (code < 0x80) {
+        bytes[0] = (char)code;
+        n = 1;
+    } else if (code < 0x800) {
+        bytes[0] = (char)(0xC0 | (code >> 6));
+        bytes[1] = (char)(0x80 | (code & 0x3F));
+        n = 2;
+    } else if (code < 0x10000) {
+        bytes[0] = (char)(0xE0 | (code >> 12));
+        bytes[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        bytes[2] = (char)(0x80 | (code & 0x3F));
+        n = 3;
+    } else {
+        bytes[0] = (char)(0xF0 | (code >> 18));
+        bytes[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+        bytes[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+        bytes[3] = (char)(0x80 | (code & 0x3F));
+        n = 4;
+    }
+    if (*length + n < size) {
+        memcpy(value + *length, bytes, n);
+        *length += n;
+    }
+}
+
+bool readJsonHex(RecordReader *reader, unsigned int *code) {
+    *code = 0;
+    for (int k = 0; k < 4; k++) {
+        int c = readerNext(reader);
+        if (!isxdigit(c)) {
+            return false;
+        }
+        *code = *code * 16 + (unsigned int)(isdigit(c) ? c - '0' : foldCase(c) - 'a' + 10);
+    }
+    return true;
+}
+
+// Read a JSON string (the opening quote already consumed) into value, cut
+// to fit, decoding escapes. Returns false if it is malformed.
+bool readJsonString(RecordReader *reader, char *value, size_t size) {
+    size_t length = 0;
+    for (;;) {
+        readerCopyUntil(reader, '"', '\\', value, size, &length);
+        int c = readerNext(reader);
+        if (c == EOF || c == '\n') {
+            return false;
+        }
+        if (c == '"') {
+            break;
+        }
+        if (c == '\\') {
+            c = readerNext(reader);
+            unsigned int code;
+            switch (c) {
+                case '"': case '\\': case '/': break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u':
+                    if (!readJsonHex(reader, &code)) {
+                        return false;
+                    }
+                    // A high surrogate must pair with the low one that follows. An
+                    // unpaired surrogate has no UTF-8 form, and a NUL would cut the
+                    // description short, so both make the record malformed.
+                    if (code >= 0xD800 && code < 0xDC00) {
+                        unsigned int low;
+                        if (readerNext(reader) != '\\' || readerNext(reader) != 'u' ||
+                            !readJsonHex(reader, &low) || low < 0xDC00 || low >= 0xE000) {
+                            return false;
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (code == 0 || (code >= 0xDC00 && code < 0xE000)) {
+                        return false;
+                    }
+                    putUtf8(value, size, &length, code);
+                    continue;
+                default:
+                    return false;
+            }
+        }
+        if (length < size - 1) {
+            value[length++] = (char)c;
+        }
+    }
+    value[length] = '\0';
+    return true;
+}
+
+// Read a bare JSON value (number, true, false or null) into value
+bool readJsonLiteral(RecordReader *reader, char *value, size_t size) {
+    size_t length = 0;
+    int c = readerPeek(reader);
+    while (isalnum(c) || c == '-' || c == '+' || c == '.') {
+        if (length < size - 1) {
+            value[length++] = (char)c;
+        }
+        readerNext(reader);
+        c = readerPeek(reader);
+    }
+    value[length] = '\0';
+    return length > 0;
+}
+
+// Parse one JSON object of flat fields into t; returns why it was rejected, or NULL
+const char* parseJsonObject(RecordReader *reader, Task *t) {
+    char key[CSV_HEADER_NAME_MAX];
+    char value[MAX_DESCRIPTION];
+    unsigned int seen = 0;
+    const char *error = NULL;
+    
+    if (readerNext(reader) != '{') {
+        return "expected a JSON object";
+    }
+    skipJsonSpace(reader);
+    if (readerPeek(reader) == '}') {
+        readerNext(reader);
+        return checkRecordFields(t, seen);
+    }
+    for (;;) {
+        skipJsonSpace(reader);
+        if (readerNext(reader) != '"' || !readJsonString(reader, key, sizeof(key))) {
+            return "malformed JSON key";
+        }
+        skipJsonSpace(reader);
+        if (readerNext(reader) != ':') {
+            return "expected ':' after a JSON key";
+        }
+        skipJsonSpace(reader);
+        
+        bool isString = readerPeek(reader) == '"';
+        if (isString) {
+            readerNext(reader);
+        }
+        if (isString ? !readJsonString(reader, value, sizeof(value)) : !readJsonLiteral(reader, value, sizeof(value))) {
+            return isString ? "malformed JSON string" : "malformed or nested JSON value";
+        }
+        if (error == NULL && (isString || strcmp(value, "null") != 0)) {
+            error = setRecordField(t, recordFieldByName(key), value, &seen);
+        }
+        
+        skipJsonSpace(reader);
+        int c = readerNext(reader);
+        if (c == '}') {
+            break;
+        }
+        if (c != ',') {
+            return "expected ',' or '}' in a JSON object";
+        }
+    }
+    return error != NULL ? error : checkRecordFields(t, seen);
+}
+
+// Read the next JSON-lines record into t; same results as nextCsvRecord()
+int nextJsonRecord(RecordReader *reader, Task *t, const char **error) {
+    int c;
+    while ((c = readerPeek(reader)) == ' ' || c == '\t' || c == '\r' || c == '\n') {
+        readerNext(reader);
+    }
+    if (c == EOF) {
+        return 0;
+    }
+    
+    memset(t, 0, sizeof(*t));
+    reader->recordLine = reader->line;
+    *error = parseJsonObject(reader, t);
+    skipJsonSpace(reader);
+    c = readerPeek(reader);
+    if (*error == NULL && c != '\n' && c != EOF) {
+        *error = "text after the JSON object";
+    }
+    if (*error != NULL) {
+        if (reader->line == reader->recordLine) {
+            readerSkipLine(reader);
+        }
+        return -1;
+    }
+    return 1;
+}
+
+// Read the next "PRIORITY DURATION DESCRIPTION" line into t, skipping blank
+// lines and '#' comments; same results as nextCsvRecord()
+int nextTextRecord(RecordReader *reader, Task *t, const char **error) {
+    char line[TASK_LINE_MAX];
+    for (;;) {
+        int c = readerPeek(reader);
+        if (c == EOF) {
+            return 0;
+        }
+        // Overlong lines keep what fits, as the interactive prompt does
+        size_t length = 0;
+        reader->recordLine = reader->line;
+        readerCopyUntil(reader, '\n', '\n', line, sizeof(line), &length);
+        readerNext(reader);
+        line[length] = '\0';
+        
+        char *text = line + strspn(line, " \t\r");
+        if (*text != '\0' && *text != '#') {
+            *error = parseTaskRecord(text, t);
+            return *error == NULL ? 1 : -1;
+        }
+    }
+}
+
+int nextRecord(RecordReader *reader, RecordFormat format, Task *t, const char **error) {
+    switch (format) {
+        case FORMAT_CSV: return nextCsvRecord(reader, t, error);
+        case FORMAT_JSONL: return nextJsonRecord(reader, t, error);
+        default: return nextTextRecord(reader, t, error);
+    }
+}
+
+// Digits of a number, without the cost of printf
+size_t formatDecimal(char *out, long long value) {
+    char digits[24];
+    int n = 0;
+    unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    
+    size_t length = 0;
+    if (value < 0) {
+        out[length++] = '-';
+    }
+    while (n > 0) {
+        out[length++] = digits[--n];
+    }
+    return length;
+}
+
+size_t formatCsvText(char *out, const char *text) {
+    if (text[strcspn(text, ",\"\r\n")] == '\0') {
+        size_t length = strlen(text);
+        memcpy(out, text, length);
+        return length;
+    }
+    size_t length = 0;
+    out[length++] = '"';
+    for (; *text != '\0'; text++) {
+        if (*text == '"') {
+            out[length++] = '"';
+        }
+        out[length++] = *text;
+    }
+    out[length++] = '"';
+    return length;
+}
+
+size_t formatJsonText(char *out, const char *text) {
+    static const char hex[] = "0123456789abcdef";
+    size_t length = 0;
+    out[length++] = '"';
+    for (; *text != '\0'; text++) {
+        unsigned char c = (unsigned char)*text;
+        if (c == '"' || c == '\\') {
+            out[length++] = '\\';
+            out[length++] = (char)c;
+        } else if (c == '\t') {
+            out[length++] = '\\';
+            out[length++] = 't';
+        } else if (c < 0x20) {
+            memcpy(out + length, "\\u00", 4);
+            out[length + 4] = hex[c >> 4];
+            out[length + 5] = hex[c & 15];
+            length += 6;
+        } else {
+            out[length++] = (char)c;
+        }
+    }
+    out[length++] = '"';
+    return length;
+}
+
+// One task as a line of the given format, into out (EXPORT_ROW_MAX bytes)
+size_t formatTaskRow(char *out, int slot, RecordFormat format) {
+    const char *priority = priorityToString(taskPriorities[slot]);
+    const char *completed = taskCompleted[slot] ? "true" : "false";
+    size_t n = 0;
+    
+    if (format == FORMAT_TEXT) {
+        n += (size_t)sprintf(out, "%s ", priority);
+        n += formatDecimal(out + n, taskDurations[slot]);
+        out[n++] = ' ';
+        size_t length = strlen(taskDescription(slot));
+        memcpy(out + n, taskDescription(slot), length);
+        n += length;
+    } else if (format == FORMAT_CSV) {
+        n += formatDecimal(out + n, taskIds[slot]);
+        out[n++] = ',';
+        n += formatCsvText(out + n, taskDescription(slot));
+        n += (size_t)sprintf(out + n, ",%s,", priority);
+        n += formatDecimal(out + n, taskDurations[slot]);
+        out[n++] = ',';
+        n += formatDecimal(out + n, (long long)taskCreated[slot]);
+        n += (size_t)sprintf(out + n, ",%s", completed);
+    } else {
+        memcpy(out, "{\"id\":", 6);
+        n = 6;
+        n += formatDecimal(out + n, taskIds[slot]);
+        memcpy(out + n, ",\"description\":", 15);
+        n += 15;
+        n += formatJsonText(out + n, taskDescription(slot));
+        n += (size_t)sprintf(out + n, ",\"priority\":\"%s\",\"duration\":", priority);
+        n += formatDecimal(out + n, taskDurations[slot]);
+        memcpy(out + n, ",\"created\":", 11);
+        n += 11;
+        n += formatDecimal(out + n, (long long)taskCreated[slot]);
+        n += (size_t)sprintf(out + n, ",\"completed\":%s}", completed);
+    }
+    out[n++] = '\n';
+    return n;
+}
+
+// Write every task, in list order, one line at a time. Returns the number
+// written, or -1 if the output failed.
+long long exportTasks(FILE *out, RecordFormat format) {
+    char row[EXPORT_ROW_MAX];
+    if (format == FORMAT_CSV) {
+        fputs("id,description,priority,duration,created,completed\n", out);
+    }
+    
+    long long exported = 0;
+    for (int i = 0; i < taskSlotCount; i++) {
+        if (taskIds[i] == 0) {
+            continue;
+        }
+        size_t length = formatTaskRow(row, i, format);
+        if (fwrite(row, 1, length, out) != length) {
+            return -1;
+        }
+        exported++;
+    }
+    return fflush(out) == 0 && !ferror(out) ? exported : -1;
+}
+
+// Add every record of a stream in the given format, in one buffered pass
+// that holds a single record at a time. The caller flushes the journal once
+// at the end.
+bool importTasks(FILE *in, const char *name, RecordFormat format, bool keepDuplicates) {
+    RecordReader reader;
+    if (!readerInit(&reader, in)) {
+        return false;
+    }
+    int added = 0, duplicates = 0, rejected = 0, renumbered = 0;
+    bool ok = true;
+    double start = monotonicSeconds();
+    
+    // Index the new descriptions for search in one rebuild when a search
+    // next needs them, rather than record by record
+    trigramIndexStale = true;
+    
+    Task t;
+    const char *error;
+    int status;
+    while ((status = nextRecord(&reader, format, &t, &error)) != 0) {
+        if (status < 0) {
+            if (rejected++ < IMPORT_ERROR_PREVIEW) {
+                printf("Error: %s line %lld: %s.\n", name, reader.recordLine, error);
+            }
+            continue;
+        }
+        
+        int requestedId = t.id;
+        bool isNew;
+        if (!addTaskRecord(&t, keepDuplicates, &isNew)) {
+            ok = false;
+            break;
+        }
+        if (!isNew) {
+            duplicates++;
+        } else {
+            added++;
+            renumbered += requestedId != 0 && t.id != requestedId;
+        }
+    }
+    if (ferror(in)) {
+        printf("Error: Cannot read %s.\n", name);
+        ok = false;
+    }
+    readerFree(&reader);
+    
+    double elapsed = monotonicSeconds() - start;
+    printf("Imported %d task(s) from %s in %.3f s (%.0f tasks/s)\n", added, name, elapsed,
+           elapsed > 0 ? added / elapsed : 0.0);
+    if (renumbered > 0) {
+        printf("Gave %d task(s) a new ID because theirs had already been used\n", renumbered);
+    }
+    if (duplicates > 0) {
+        printf("Skipped %d duplicate(s); use --keep-duplicates to add them anyway\n", duplicates);
+    }
+    if (rejected > 0) {
+        printf("Rejected %d malformed record(s)\n", rejected);
+    }
+    return ok && rejected == 0;
+}
+
+// add [--keep-duplicates] PRIORITY DURATION DESCRIPTION...
+int commandAdd(int argc, char *argv[]) {
+    bool keepDuplicates = argc > 0 && strcmp(argv[0], "--keep-duplicates") == 0;
+    if (keepDuplicates) {
+        argc--;
+        argv++;
+    }
+    if (argc < 3) {
+        printf("Usage: task_manager add [--keep-duplicates] PRIORITY DURATION DESCRIPTION...\n");
+        return 1;
+    }
+    
+    // Rebuild the record the import parser expects from the arguments
+    char line[TASK_LINE_MAX];
+    size_t used = 0;
+    for (int i = 0; i < argc && used < sizeof(line) - 1; i++) {
+        int written = snprintf(line + used, sizeof(line) - used, i == 0 ? "%s" : " %s", argv[i]);
+        used += written < 0 ? 0 : (size_t)written;
+    }
+    
+    Task t;
+    const char *error = parseTaskRecord(line, &t);
+    if (error != NULL) {
+        printf("Error: %s.\n", error);
+        return 1;
+    }
+    
+    int duplicate = findDuplicateTask(t.description, t.priority, t.duration);
+    bool added;
+    if (!addTaskRecord(&t, keepDuplicates, &added)) {
+        return 1;
+    }
+    if (!added) {
+        printf("Similar task already exists (ID %d); use --keep-duplicates to add it anyway.\n",
+               taskIds[duplicate]);
+        return 1;
+    }
+    printf("Added task %d\n", t.id);
+    return 0;
+}
+
+// import [--keep-duplicates] [--format text|csv|jsonl] [FILE|-]: records
+// from a file, or stdin. The format defaults to the file's extension, else text.
+int commandImport(int argc, char *argv[]) {
+    bool keepDuplicates = false, formatGiven = false;
+    RecordFormat format = FORMAT_TEXT;
+    int a = 0;
+    for (; a < argc && strncmp(argv[a], "--", 2) == 0; a++) {
+        if (strcmp(argv[a], "--keep-duplicates") == 0) {
+            keepDuplicates = true;
+        } else if (strcmp(argv[a], "--format") == 0 && a + 1 < argc && parseRecordFormat(argv[a + 1], &format)) {
+            formatGiven = true;
+            a++;
+        } else {
+            break;
+        }
+    }
+    if (argc - a > 1 || (a < argc && strncmp(argv[a], "--", 2) == 0)) {
+        printf("Usage: task_manager import [--keep-duplicates] [--format text|csv|jsonl] [FILE|-]\n");
+        return 1;
+    }
+    
+    if (a == argc || strcmp(argv[a], "-") == 0) {
+        return importTasks(stdin, "stdin", format, keepDuplicates) ? 0 : 1;
+    }
+    FILE *in = fopen(argv[a], "rb");
+    if (in == NULL) {
+        printf("Error: Cannot open %s.\n", argv[a]);
+        return 1;
+    }
+    bool ok = importTasks(in, argv[a], formatGiven ? format : formatForPath(argv[a], FORMAT_TEXT), keepDuplicates);
+    fclose(in);
+    return ok ? 0 : 1;
+}
+
+// export [--format text|csv|jsonl] [FILE|-]: every task to a file, or
+// stdout. The format defaults to the file's extension, else CSV.
+int commandExport(int argc, char *argv[]) {
+    bool formatGiven = argc >= 2 && strcmp(argv[0], "--format") == 0;
+    RecordFormat format = FORMAT_CSV;
+    int first = formatGiven ? 2 : 0;
+    if ((formatGiven && !parseRecordFormat(argv[1], &format)) || argc - first > 1 ||
+        (argc > first && strncmp(argv[first], "--", 2) == 0)) {
+        printf("Usage: task_manager export [--format text|csv|jsonl] [FILE|-]\n");
+        return 1;
+    }
+    const char *path = argc > first ? argv[first] : "-";
+    
+    ensureIndexes();
+    if (strcmp(path, "-") == 0) {
+        return exportTasks(stdout, format) < 0 ? 1 : 0;
+    }
+    FILE *out = fopen(path, "wb");
+    if (out == NULL) {
+        printf("Error: Cannot open %s for writing.\n", path);
+        return 1;
+    }
+    setvbuf(out, NULL, _IOFBF, STREAM_BUFFER_SIZE);
+    double start = monotonicSeconds();
+    long long exported = exportTasks(out, formatGiven ? format : formatForPath(path, FORMAT_CSV));
+    if (fclose(out) != 0 || exported < 0) {
+        printf("Error: Cannot write to %s.\n", path);
+        return 1;
+    }
+    printf("Exported %lld task(s) to %s in %.3f s\n", exported, path, monotonicSeconds() - start);
+    return 0;
+}
+
+// query [--pending|--done] [--priority P] [TERMS...]: matching tasks as
+// tab-separated id, priority, duration, status and description, in list
+// order. Each filter is answered from its index.
+int commandQuery(int argc, char *argv[]) {
+    bool pendingOnly = false, doneOnly = false, byPriority = false, valid = true;
+    Priority priority = HIGH;
+    size_t queryLength = 1;
+    int firstTerm = argc;
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "--pending") == 0) {
+            pendingOnly = true;
+        } else if (strcmp(argv[i], "--done") == 0) {
+            doneOnly = true;
+        } else if (strcmp(argv[i], "--priority") == 0 && i + 1 < argc &&
+                   parsePriorityName(argv[i + 1], &priority)) {
+            byPriority = true;
+            i++;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            valid = false;
+            break;
+        } else {
+            firstTerm = i;
+            break;
+        }
+    }
+    if (!valid || (pendingOnly && doneOnly)) {
+        printf("Usage: task_manager query [--pending|--done] [--priority high|medium|low] [TERMS...]\n");
+        return 1;
+    }
+    for (int i = firstTerm; i < argc; i++) {
+        queryLength += strlen(argv[i]) + 1;
+    }
+    
+    // Start from the narrowest index the query names, then filter by the rest
+    int count = 0;
+    int *slots;
+    if (firstTerm < argc) {
+        char *query = (char*)malloc(queryLength);
+        if (query == NULL) {
+            printf("Memory allocation error\n");
+            return 1;
+        }
+        query[0] = '\0';
+        for (int i = firstTerm; i < argc; i++) {
+            strcat(query, argv[i]);
+            strcat(query, " ");
+        }
+        slots = searchDescriptions(query, &count);
+        free(query);
+    } else if (byPriority) {
+        slots = priorityTaskSlots(priority, &count);
+    } else if (pendingOnly) {
+        slots = pendingTaskSlots(&count);
+    } else {
+        ensureIndexes();
+        slots = (int*)malloc(((size_t)taskSlotCount + 1) * sizeof(int));
+        if (slots != NULL) {
+            for (int i = 0; i < taskSlotCount; i++) {
+                if (taskIds[i] != 0) {
+                    slots[count++] = i;
+                }
+            }
+        }
+    }
+    if (slots == NULL) {
+        return 1;
+    }
+    
+    for (int n = 0; n < count; n++) {
+        int i = slots[n];
+        if ((pendingOnly && taskCompleted[i]) || (doneOnly && !taskCompleted[i]) ||
+            (byPriority && taskPriorities[i] != priority)) {
+            continue;
+        }
+        printf("%d\t%s\t%d\t%s\t%s\n", taskIds[i], priorityToString(taskPriorities[i]),
+               taskDurations[i], taskCompleted[i] ? "Done" : "Pending", taskDescription(i));
+    }
+    free(slots);
+    return 0;
+}
+
+// run [--workers N] [--policy NAME] [all|ID...]: execute pending tasks on the
+// pool without prompts; every pending task when no IDs are given
+int commandRun(int argc, char *argv[]) {
+    int workers = processorCount();
+    SchedulePolicy policy = schedulePolicy;
+    int first = 0;
+    for (; first < argc && strncmp(argv[first], "--", 2) == 0; first += 2) {
+        bool valid = first + 1 < argc;
+        if (valid && strcmp(argv[first], "--workers") == 0) {
+            workers = atoi(argv[first + 1]);
+            valid = workers >= 1 && workers <= MAX_EXECUTOR_WORKERS;
+        } else if (valid && strcmp(argv[first], "--policy") == 0) {
+            valid = parsePolicyName(argv[first + 1], &policy);
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            printf("Usage: task_manager run [--workers 1-%d] [--policy fifo|priority|sjf|lpt|weighted] [all|ID...]\n",
+                   MAX_EXECUTOR_WORKERS);
+            return 1;
+        }
+    }
+    
+    ensureIndexes();
+    bool *selectedTasks = (bool*)calloc((size_t)taskSlotCount + 1, sizeof(bool));
+    if (selectedTasks == NULL) {
+        printf("Memory allocation error\n");
+        return 1;
+    }
+    int numSelected = 0;
+    if (first == argc || (first + 1 == argc && strcmp(argv[first], "all") == 0)) {
+        for (int i = 0; i < taskSlotCount; i++) {
+            if (taskIds[i] != 0 && !taskCompleted[i]) {
+                selectedTasks[i] = true;
+                numSelected++;
+            }
+        }
+    } else {
+        for (int a = first; a < argc; a++) {
+            int i = findTaskIndex(atoi(argv[a]));
+            if (i < 0 || taskCompleted[i]) {
+                printf("Skipping %s: no pending task with that ID.\n", argv[a]);
+            } else if (!selectedTasks[i]) {
+                selectedTasks[i] = true;
+                numSelected++;
+            }
+        }
+    }
+    
+    int jobCount;
+    ExecutionJob *jobs = jobsForSelection(selectedTasks, numSelected, &jobCount);
+    free(selectedTasks);
+    if (jobs == NULL) {
+        return numSelected == 0 ? 0 : 1;
+    }
+    JobGraph graph;
+    if (!buildJobGraph(&graph, jobs, jobCount)) {
+        free(jobs);
+        return 1;
+    }
+    runJobsOnPool(jobs, jobCount, &graph, workers, policy, false);
+    freeJobGraph(&graph);
+    free(jobs);
+    return 0;
+}
+
+// batch [FILE|-]: one command per line (add, import, export, query or run,
+// with the same arguments as on the command line), all flushed together at
+// the end
+int commandBatch(int argc, char *argv[]) {
+    if (argc > 1) {
+        printf("Usage: task_manager batch [FILE|-]\n");
+        return 1;
+    }
+    bool fromStdin = argc == 0 || strcmp(argv[0], "-") == 0;
+    FILE *in = fromStdin ? stdin : fopen(argv[0], "r");
+    if (in == NULL) {
+        printf("Error: Cannot open %s.\n", argv[0]);
+        return 1;
+    }
+    
+    int status = 0;
+    long long lineNumber = 0;
+    char *line;
+    while ((line = readLine(in)) != NULL) {
+        lineNumber++;
+        char *words[BATCH_MAX_WORDS];
+        int wordCount = 0;
+        bool tooLong = false;
+        for (char *word = strtok(line, " \t\r"); word != NULL; word = strtok(NULL, " \t\r")) {
+            if (wordCount == BATCH_MAX_WORDS) {
+                tooLong = true;
+                break;
+            }
+            words[wordCount++] = word;
+        }
+        
+        if (wordCount > 0 && words[0][0] != '#') {
+            if (tooLong) {
+                // Running it with the tail cut off would, say, store a shortened description
+                printf("Error: line %lld: more than %d words; the line was skipped.\n", lineNumber, BATCH_MAX_WORDS);
+                status = 1;
+            } else if (!isCommand(words[0]) || strcmp(words[0], "batch") == 0) {
+                printf("Error: line %lld: unknown command '%s'.\n", lineNumber, words[0]);
+                status = 1;
+            } else if (dispatchCommand(wordCount, words) != 0) {
+                status = 1;
             }
+        }
+        free(line);
+    }
+    if (!fromStdin) {
+        fclose(in);
+    }
+    return status;
+}
+
+bool isCommand(const char *name) {
+    return strcmp(name, "add") == 0 || strcmp(name, "import") == 0 || strcmp(name, "export") == 0 ||
+           strcmp(name, "query") == 0 || strcmp(name, "run") == 0 || strcmp(name, "batch") == 0;
+}
+
+// Run one command (argv[0] is its name) against the loaded task store
+int dispatchCommand(int argc, char *argv[]) {
+    if (strcmp(argv[0], "add") == 0) {
+        return commandAdd(argc - 1, argv + 1);
+    } else if (strcmp(argv[0], "import") == 0) {
+        return commandImport(argc - 1, argv + 1);
+    } else if (strcmp(argv[0], "export") == 0) {
+        return commandExport(argc - 1, argv + 1);
+    } else if (strcmp(argv[0], "query") == 0) {
+        return commandQuery(argc - 1, argv + 1);
+    } else if (strcmp(argv[0], "run") == 0) {
+        return commandRun(argc - 1, argv + 1);
+    }
+    return commandBatch(argc - 1, argv + 1);
+}
+
+// Non-interactive mode: load the tasks, run the command, then make all of
+// its changes durable in a single flush
+int runCommandLine(int argc, char *argv[]) {
+    loadSnapshot(FILENAME, MMAP_STORAGE);
+    replayJournal();
+    
+    int status = dispatchCommand(argc, argv);
+    flushJournalBatch();
+    
+    stopExecutor();
+    if (journalFile != NULL) {
+        fclose(journalFile);
+    }
+    resetTaskStore();
+    return status;
+}
+
+// Wall-clock seconds from a monotonic source, for timing benchmarks
+double monotonicSeconds() {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+// Deterministic xorshift generator so benchmark runs are repeatable
+unsigned int benchmarkSeed = 2463534242u;
+
+unsigned int benchmarkRandom() {
+    benchmarkSeed ^= benchmarkSeed << 13;
+    benchmarkSeed ^= benchmarkSeed >> 17;
+    benchmarkSeed ^= benchmarkSeed << 5;
+    return benchmarkSeed;
+}
+
+// Replace the in-memory task list with `count` generated tasks (nothing is saved)
+void generateSyntheticTasks(int count) {
+    static const char *words[] = {
+        "backup", "database", "deploy", "review", "report", "invoice", "server",
+        "update", "cleanup", "migrate", "monitor", "patch", "index", "archive",
+        "email", "schedule", "billing", "release", "audit", "cache"
+    };
+    const int wordCount = (int)(sizeof(words) / sizeof(words[0]));
+    const Priority priorities[] = {HIGH, MEDIUM, LOW};
+    time_t base = time(NULL) - count;
+    
+    resetTaskStore();
+    benchmarkSeed = 2463534242u;
+    reserveTasks(count);
+    reserveIdIndex(count);
+    
+    for (int i = 0; i < count; i++) {
+        Task t;
+        t.id = nextTaskId++;
+        snprintf(t.description, MAX_DESCRIPTION, "%s %s %s #%d",
+                 words[benchmarkRandom() % wordCount],
+                 words[benchmarkRandom() % wordCount],
+                 words[benchmarkRandom() % wordCount], t.id);
+        t.priority = priorities[benchmarkRandom() % 3];
+        t.duration = 1 + (int)(benchmarkRandom() % 3600);
+        t.created = base + i;
+        t.completed = benchmarkRandom() % 4 == 0;
+        if (!appendTask(&t)) {
             break;
         }
-        case 2: {
-            int priorityChoice;
-            printf("Select priority to search for:\n");
-            printf("1. High\n");
-            printf("2. Medium\n");
-            printf("3. Low\n");
-            printf("Choice: ");
-            scanf("%d", &priorityChoice);
-            
-            Priority searchPriority;
-            switch (priorityChoice) {
-                case 1: searchPriority = HIGH; break;
-                case 2: searchPriority = MEDIUM; break;
-                case 3: searchPriority = LOW; break;
-                default: printf("Invalid choice.\n"); return;
+    }
+}
+
+// Compare ID lookups through the hash index against the old linear scan
+void runLookupBenchmark(int count) {
+    printf("Generating %d tasks...\n", count);
+    generateSyntheticTasks(count);
+    
+    int hashLookups = 1000000;
+    int scanLookups = (int)(200000000.0 / count);
+    if (scanLookups < 10) scanLookups = 10;
+    if (scanLookups > hashLookups) scanLookups = hashLookups;
+    
+    volatile long long sink = 0;
+    
+    double start = monotonicSeconds();
+    for (int n = 0; n < scanLookups; n++) {
+        int id = 1 + (int)(benchmarkRandom() % (unsigned int)taskCount);
+        for (int i = 0; i < taskCount; i++) {
+            if (taskIds[i] == id) {
+                sink += i;
+                break;
             }
-            
-            printf("\n=== Search Results ===\n");
-            int found = 0;
-            
-            for (int i = 0; i < taskCount; i++) {
-                if (tasks[i].priority == searchPriority) {
-                    displayTaskDetails(tasks[i]);
-                    found++;
-                }
+        }
+    }
+    double scanTime = monotonicSeconds() - start;
+    
+    start = monotonicSeconds();
+    for (int n = 0; n < hashLookups; n++) {
+        int id = 1 + (int)(benchmarkRandom() % (unsigned int)taskCount);
+        sink += findTaskIndex(id);
+    }
+    double hashTime = monotonicSeconds() - start;
+    
+    double scanNs = scanTime * 1e9 / scanLookups;
+    double hashNs = hashTime * 1e9 / hashLookups;
+    printf("\n=== Lookup Benchmark (%d tasks) ===\n", taskCount);
+    printf("Linear scan: %12.1f ns/lookup (%d lookups)\n", scanNs, scanLookups);
+    printf("Hash index:  %12.1f ns/lookup (%d lookups)\n", hashNs, hashLookups);
+    printf("Speedup:     %12.1fx\n", hashNs > 0 ? scanNs / hashNs : 0.0);
+    (void)sink;
+}
+
+// Compare the old exchange sort against the merge sort engine
+void runSortBenchmark(int count) {
+    printf("Generating %d tasks...\n", count);
+    generateSyntheticTasks(count);
+    
+    // The exchange sort is quadratic, so time it on a prefix only
+    int exchangeCount = count < 20000 ? count : 20000;
+    Task *copy = (Task*)malloc((size_t)exchangeCount * sizeof(Task));
+    int *slots = (int*)malloc((size_t)count * sizeof(int));
+    if (copy == NULL || slots == NULL) {
+        printf("Memory allocation error\n");
+        free(copy);
+        free(slots);
+        return;
+    }
+    for (int i = 0; i < exchangeCount; i++) {
+        copy[i] = taskAt(i);
+    }
+    
+    double start = monotonicSeconds();
+    for (int i = 0; i < exchangeCount - 1; i++) {
+        for (int j = i + 1; j < exchangeCount; j++) {
+            if (copy[i].priority > copy[j].priority ||
+               (copy[i].priority == copy[j].priority && copy[i].duration > copy[j].duration)) {
+                Task temp = copy[i];
+                copy[i] = copy[j];
+                copy[j] = temp;
             }
-            
-            if (found == 0) {
-                printf("No tasks found with %s priority\n", priorityToString(searchPriority));
-            } else {
-                printf("%d task(s) found.\n", found);
+        }
+    }
+    double exchangeTime = monotonicSeconds() - start;
+    
+    for (int i = 0; i < exchangeCount; i++) slots[i] = i;
+    start = monotonicSeconds();
+    sortTaskSlots(slots, exchangeCount, SORT_BY_PRIORITY, 1);
+    double mergePrefixTime = monotonicSeconds() - start;
+    
+    printf("\n=== Sort Benchmark (%d tasks, %d threads available) ===\n", count, processorCount());
+    printf("Exchange sort, %d tasks:     %10.2f ms\n", exchangeCount, exchangeTime * 1e3);
+    printf("Merge sort, %d tasks:        %10.2f ms (%.0fx faster)\n", exchangeCount, mergePrefixTime * 1e3,
+           mergePrefixTime > 0 ? exchangeTime / mergePrefixTime : 0.0);
+    
+    const char *keyNames[] = {"", "priority", "duration", "created"};
+    for (int key = SORT_BY_PRIORITY; key <= SORT_BY_CREATED; key++) {
+        for (int i = 0; i < count; i++) slots[i] = i;
+        start = monotonicSeconds();
+        sortTaskSlots(slots, count, (SortKey)key, 1);
+        double sequentialTime = monotonicSeconds() - start;
+        
+        for (int i = 0; i < count; i++) slots[i] = i;
+        start = monotonicSeconds();
+        sortTaskSlots(slots, count, (SortKey)key, processorCount());
+        double parallelTime = monotonicSeconds() - start;
+        
+        printf("By %-8s %d tasks: sequential %9.2f ms, parallel %9.2f ms\n",
+               keyNames[key], count, sequentialTime * 1e3, parallelTime * 1e3);
+    }
+    
+    free(copy);
+    free(slots);
+}
+
+// Compare indexed description search against a strstr scan of every task
+void runSearchBenchmark(int count) {
+    printf("Generating %d tasks...\n", count);
+    generateSyntheticTasks(count);
+    
+    double start = monotonicSeconds();
+    rebuildTrigramIndex();
+    double buildTime = monotonicSeconds() - start;
+    
+    size_t indexBytes = (size_t)trigramTableCapacity * sizeof(TrigramPostings);
+    for (int i = 0; i < trigramTableCapacity; i++) {
+        if (trigramTable[i].key != TRIGRAM_EMPTY) {
+            indexBytes += (size_t)trigramTable[i].capacity * sizeof(int);
+        }
+    }
+    char indexSize[32];
+    formatBytes(indexBytes, indexSize, sizeof(indexSize));
+    
+    printf("\n=== Search Benchmark (%d tasks) ===\n", taskCount);
+    printf("Index build: %.2f ms, %d trigrams, %s\n", buildTime * 1e3, trigramTableCount, indexSize);
+    printf("%-22s %8s %12s %12s %9s\n", "Query", "Matches", "Scan (ms)", "Index (ms)", "Speedup");
+    
+    const char *queries[] = {"#4242", "invoice", "backup deploy", "\"cache report\" #99", "ck"};
+    for (int q = 0; q < (int)(sizeof(queries) / sizeof(queries[0])); q++) {
+        char buffer[64];
+        strcpy(buffer, queries[q]);
+        char **terms;
+        int termCount = splitSearchTerms(buffer, &terms);
+        
+        // The old search: strstr over every description, one pass per query
+        volatile int scanMatches = 0;
+        start = monotonicSeconds();
+        for (int i = 0; i < taskSlotCount; i++) {
+            bool match = taskIds[i] != 0;
+            for (int t = 0; t < termCount && match; t++) {
+                match = strstr(taskDescription(i), terms[t]) != NULL;
             }
-            break;
+            if (match) scanMatches++;
         }
-        case 3:
-            return;
-        default:
-            printf("Invalid choice.\n");
+        double scanTime = monotonicSeconds() - start;
+        free(terms);
+        
+        int repeats = 0;
+        int found = 0;
+        start = monotonicSeconds();
+        do {
+            int *matches = searchDescriptions(queries[q], &found);
+            free(matches);
+            repeats++;
+        } while (monotonicSeconds() - start < 0.2 && repeats < 1000);
+        double indexTime = (monotonicSeconds() - start) / repeats;
+        
+        printf("%-22s %8d %12.3f %12.3f %8.1fx\n", queries[q], found, scanTime * 1e3, indexTime * 1e3,
+               indexTime > 0 ? scanTime / indexTime : 0.0);
     }
+    printf("(Index search ignores case; the scan column is the old case-sensitive strstr loop.)\n");
 }
 
-// Delete a task
-void deleteTask() {
-    if (taskCount == 0) {
-        printf("\nNo tasks available to delete.\n");
+// Throughput of the substring kernels against strstr, per description and over one large buffer
+void runSubstringBenchmark(int count) {
+    printf("Generating %d tasks...\n", count);
+    generateSyntheticTasks(count);
+    selectSubstringKernel();
+    
+    SubstringKernel kernels[3];
+    const char *kernelNames[3];
+    int kernelCount = 0;
+    kernels[kernelCount] = findIgnoreCaseScalar;
+    kernelNames[kernelCount++] = "scalar";
+#ifdef HAVE_X86_SIMD
+    if (__builtin_cpu_supports("sse2")) {
+        kernels[kernelCount] = findIgnoreCaseSse2;
+        kernelNames[kernelCount++] = "SSE2";
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels[kernelCount] = findIgnoreCaseAvx2;
+        kernelNames[kernelCount++] = "AVX2";
+    }
+#endif
+    
+    // One buffer holding every description, for the raw scanning rate
+    size_t totalBytes = 0;
+    for (int i = 0; i < taskSlotCount; i++) {
+        totalBytes += strlen(taskDescription(i)) + 1;
+    }
+    char *corpus = (char*)malloc(totalBytes + 1);
+    if (corpus == NULL) {
+        printf("Memory allocation error\n");
         return;
     }
+    size_t offset = 0;
+    for (int i = 0; i < taskSlotCount; i++) {
+        size_t length = strlen(taskDescription(i));
+        memcpy(corpus + offset, taskDescription(i), length);
+        corpus[offset + length] = '\n';
+        offset += length + 1;
+    }
+    corpus[offset] = '\0';
     
-    printf("\n=== Delete Task ===\n");
+    printf("\n=== Substring Benchmark (%d tasks, %.1f MB of text, using %s) ===\n",
+           taskCount, totalBytes / 1e6, substringKernelName);
+    printf("%-10s %-8s %10s %12s\n", "Needle", "Kernel", "Matches", "MB/s");
     
-    // Display a compact list of tasks
-    printf("Current tasks:\n");
-    for (int i = 0; i < taskCount; i++) {
-        printf("%d: %s (%s)\n", 
-               tasks[i].id, 
-               tasks[i].description, 
-               priorityToString(tasks[i].priority));
+    const char *needles[] = {"ck", "deploy", "#4242"};
+    for (int n = 0; n < 3; n++) {
+        size_t needleLength = strlen(needles[n]);
+        
+        volatile int matches = 0;
+        double start = monotonicSeconds();
+        for (int i = 0; i < taskSlotCount; i++) {
+            if (strstr(taskDescription(i), needles[n]) != NULL) matches++;
+        }
+        double elapsed = monotonicSeconds() - start;
+        printf("%-10s %-8s %10d %12.0f\n", needles[n], "strstr", matches, totalBytes / elapsed / 1e6);
+        
+        for (int k = 0; k < kernelCount; k++) {
+            matches = 0;
+            start = monotonicSeconds();
+            for (int i = 0; i < taskSlotCount; i++) {
+                const char *description = taskDescription(i);
+                if (kernels[k](description, strlen(description), needles[n], needleLength) != NULL) matches++;
+            }
+            elapsed = monotonicSeconds() - start;
+            printf("%-10s %-8s %10d %12.0f\n", "", kernelNames[k], matches, totalBytes / elapsed / 1e6);
+        }
     }
     
-    printf("\nEnter task ID to delete (or 0 to cancel): ");
-    int id;
-    scanf("%d", &id);
+    // A needle that never occurs makes every kernel read the whole buffer
+    printf("\nWhole-buffer scan for an absent needle:\n");
+    double start = monotonicSeconds();
+    volatile const char *hit = strstr(corpus, "zq#x");
+    double elapsed = monotonicSeconds() - start;
+    printf("%-10s %-8s %10s %12.0f\n", "zq#x", "strstr", hit ? "found" : "-", totalBytes / elapsed / 1e6);
+    for (int k = 0; k < kernelCount; k++) {
+        start = monotonicSeconds();
+        hit = kernels[k](corpus, totalBytes, "zq#x", 4);
+        elapsed = monotonicSeconds() - start;
+        printf("%-10s %-8s %10s %12.0f\n", "", kernelNames[k], hit ? "found" : "-", totalBytes / elapsed / 1e6);
+    }
     
-    if (id == 0) return;
+    free(corpus);
+}
+
+// Compare reading a snapshot into a buffer with decoding it from a mapping,
+// and measure checksum speed. The file was just written, so both runs read
+// from the page cache. Both decode every task, so the mapping only saves
+// the copy into the buffer. Then time a cold start (load plus every index) with
+// 1, 2, 4... threads up to the core count.
+void runStartupBenchmark(int count) {
+    const char *path = "bench_startup.dat";
     
-    // Find and delete the task
-    for (int i = 0; i < taskCount; i++) {
-        if (tasks[i].id == id) {
-            printf("Deleting task: %s\n", tasks[i].description);
-            printf("Are you sure? (1=Yes, 0=No): ");
-            int confirm;
-            scanf("%d", &confirm);
-            
-            if (confirm == 1) {
-                // Shift all tasks down to fill the gap
-                for (int j = i; j < taskCount - 1; j++) {
-                    tasks[j] = tasks[j + 1];
-                }
-                taskCount--;
-                printf("Task deleted successfully.\n");
-                saveTasksToFile();
-            } else {
-                printf("Deletion cancelled.\n");
-            }
-            return;
+    printf("Generating %d tasks...\n", count);
+    generateSyntheticTasks(count);
+    if (!writeSnapshot(path)) {
+        return;
+    }
+    
+    size_t fileSize = 0;
+    unsigned char *data = readFile(path, &fileSize);
+    if (data == NULL) {
+        remove(path);
+        return;
+    }
+    double start = monotonicSeconds();
+    volatile unsigned int checksum = crc32c(0, data, fileSize);
+    double crcTime = monotonicSeconds() - start;
+    free(data);
+    (void)checksum;
+    
+    double rawSize = 2.0 * sizeof(int) + (double)count * sizeof(Task);
+    printf("\n=== Startup Benchmark (%d tasks) ===\n", count);
+    printf("File size: %.1f MB (%.1f bytes/task; raw Task structs would be %.1f MB, %.1fx larger)\n",
+           fileSize / (1024.0 * 1024.0), (double)fileSize / count, rawSize / (1024.0 * 1024.0),
+           fileSize > 0 ? rawSize / fileSize : 0.0);
+    printf("CRC32C (%s): %.2f GB/s\n", crc32cKernelName, crcTime > 0 ? fileSize / crcTime / 1e9 : 0.0);
+    
+    const char *modeNames[] = {"fread", "mmap"};
+    for (int mode = 0; mode < 2; mode++) {
+        resetTaskStore();
+        start = monotonicSeconds();
+        loadSnapshot(path, mode == 1);
+        double loadTime = monotonicSeconds() - start;
+        
+        // The first lookup pays for the indexes that the load deferred
+        start = monotonicSeconds();
+        volatile int slot = findTaskIndex(1 + (int)(benchmarkRandom() % (unsigned int)count));
+        double lookupTime = monotonicSeconds() - start;
+        
+        // Touch every task once (the columns live on the heap in both modes)
+        start = monotonicSeconds();
+        volatile long long sink = 0;
+        for (int i = 0; i < taskSlotCount; i++) {
+            sink += taskDurations[i];
+        }
+        double scanTime = monotonicSeconds() - start;
+        
+        printf("%-5s load %10.3f ms | first lookup %9.2f ms | full scan %9.2f ms\n",
+               modeNames[mode], loadTime * 1e3, lookupTime * 1e3, scanTime * 1e3);
+        (void)slot;
+        (void)sink;
+    }
+    
+    printf("Both modes decode every task at load; mmap only skips copying the file into a buffer.\n");
+    
+    int cores = processorCount();
+    printf("\nCold start by thread count (mmap, %d cores):\n", cores);
+    printf("%8s %12s %12s %12s %9s\n", "threads", "decode ms", "indexes ms", "total ms", "speedup");
+    double baseline = 0;
+    for (int threads = 1; ; threads = threads * 2 < cores ? threads * 2 : cores) {
+        resetTaskStore();
+        loadThreadCount = threads;
+        start = monotonicSeconds();
+        loadSnapshot(path, true);
+        double loadTime = monotonicSeconds() - start;
+        
+        start = monotonicSeconds();
+        ensureIndexes();
+        double indexTime = monotonicSeconds() - start;
+        
+        double total = loadTime + indexTime;
+        if (threads == 1) {
+            baseline = total;
+        }
+        printf("%8d %12.1f %12.1f %12.1f %8.2fx\n", threads, loadTime * 1e3, indexTime * 1e3, total * 1e3,
+               total > 0 ? baseline / total : 0.0);
+        if (threads >= cores) {
+            break;
         }
     }
+    loadThreadCount = 0;
     
-    printf("Task with ID %d not found.\n", id);
+    resetTaskStore();
+    remove(path);
 }
 
-// Modify a task
-void modifyTask() {
-    if (taskCount == 0) {
-        printf("\nNo tasks available to modify.\n");
+// Whole-struct copy of the store for the scan benchmark's qsort comparator
+Task *scanRecords = NULL;
+
+int compareRecordSlots(const void *a, const void *b) {
+    const Task *x = &scanRecords[*(const int*)a];
+    const Task *y = &scanRecords[*(const int*)b];
+    if (x->priority != y->priority) return x->priority < y->priority ? -1 : 1;
+    if (x->duration != y->duration) return x->duration < y->duration ? -1 : 1;
+    return 0;
+}
+
+int compareColumnSlots(const void *a, const void *b) {
+    return compareTaskSlots(*(const int*)a, *(const int*)b, SORT_BY_PRIORITY);
+}
+
+// Run the same filters, counts and sort over an array of whole Task structs
+// (the old layout) and over the hot columns. With a struct each task costs a
+// cache line per pass; a column packs 64 / field-size tasks into each line.
+void runScanBenchmark(int count) {
+    printf("Generating %d tasks...\n", count);
+    generateSyntheticTasks(count);
+    
+    scanRecords = (Task*)malloc((size_t)count * sizeof(Task));
+    int *slots = (int*)malloc((size_t)count * sizeof(int));
+    if (scanRecords == NULL || slots == NULL) {
+        printf("Memory allocation error\n");
+        free(scanRecords);
+        free(slots);
+        scanRecords = NULL;
         return;
     }
+    for (int i = 0; i < count; i++) {
+        scanRecords[i] = taskAt(i);
+    }
     
-    printf("\n=== Modify Task ===\n");
+    int rounds = 100000000 / count;
+    if (rounds < 1) rounds = 1;
+    volatile long long sink = 0;
+    double recordTime[3], columnTime[3];
     
-    // Display a compact list of tasks
-    printf("Current tasks:\n");
-    for (int i = 0; i < taskCount; i++) {
-        printf("%d: %s (%s)\n", 
-               tasks[i].id, 
-               tasks[i].description, 
-               priorityToString(tasks[i].priority));
+    // Priority filter: how many tasks are HIGH
+    double start = monotonicSeconds();
+    for (int r = 0; r < rounds; r++) {
+        int matches = 0;
+        for (int i = 0; i < count; i++) matches += scanRecords[i].priority == HIGH;
+        sink += matches;
     }
+    recordTime[0] = (monotonicSeconds() - start) / rounds;
+    start = monotonicSeconds();
+    for (int r = 0; r < rounds; r++) {
+        int matches = 0;
+        for (int i = 0; i < count; i++) matches += taskPriorities[i] == HIGH;
+        sink += matches;
+    }
+    columnTime[0] = (monotonicSeconds() - start) / rounds;
     
-    printf("\nEnter task ID to modify (or 0 to cancel): ");
-    int id;
-    scanf("%d", &id);
+    // Pending count, skipping tombstones the way the store does
+    start = monotonicSeconds();
+    for (int r = 0; r < rounds; r++) {
+        int pending = 0;
+        for (int i = 0; i < count; i++) pending += scanRecords[i].id != 0 && !scanRecords[i].completed;
+        sink += pending;
+    }
+    recordTime[1] = (monotonicSeconds() - start) / rounds;
+    start = monotonicSeconds();
+    for (int r = 0; r < rounds; r++) {
+        int pending = 0;
+        for (int i = 0; i < count; i++) pending += taskIds[i] != 0 && !taskCompleted[i];
+        sink += pending;
+    }
+    columnTime[1] = (monotonicSeconds() - start) / rounds;
     
-    if (id == 0) return;
+    // Sort by priority then duration with the same algorithm on both layouts
+    for (int i = 0; i < count; i++) slots[i] = i;
+    start = monotonicSeconds();
+    qsort(slots, count, sizeof(int), compareRecordSlots);
+    recordTime[2] = monotonicSeconds() - start;
+    for (int i = 0; i < count; i++) slots[i] = i;
+    start = monotonicSeconds();
+    qsort(slots, count, sizeof(int), compareColumnSlots);
+    columnTime[2] = monotonicSeconds() - start;
     
-    // Find the task
-    for (int i = 0; i < taskCount; i++) {
-        if (tasks[i].id == id) {
-            Task *t = &tasks[i];
-            
-            printf("\n=== Modifying Task ID: %d ===\n", t->id);
-            printf("1. Description: %s\n", t->description);
-            printf("2. Priority: %s\n", priorityToString(t->priority));
-            printf("3. Duration: %d seconds\n", t->duration);
-            printf("4. Status: %s\n", t->completed ? "Completed" : "Pending");
-            printf("5. Save and return\n");
-            
-            int choice;
-            do {
-                printf("\nSelect what to modify (1-5): ");
-                scanf("%d", &choice);
-                
-                switch (choice) {
-                    case 1:
-                        clearInputBuffer();
-                        printf("New description: ");
-                        fgets(t->description, MAX_DESCRIPTION, stdin);
-                        t->description[strcspn(t->description, "\n")] = 0;
-                        break;
-                    case 2: {
-                        int priorityChoice;
-                        printf("Select new priority:\n");
-                        printf("1. High\n");
-                        printf("2. Medium\n");
-                        printf("3. Low\n");
-                        printf("Choice: ");
-                        scanf("%d", &priorityChoice);
-                        
-                        switch (priorityChoice) {
-                            case 1: t->priority = HIGH; break;
-                            case 2: t->priority = MEDIUM; break;
-                            case 3: t->priority = LOW; break;
-                            default: printf("Invalid choice.\n");
-                        }
-                        break;
-                    }
-                    case 3:
-                        do {
-                            printf("New duration (1-3600 seconds): ");
-                            scanf("%d", &t->duration);
-                            
-                            if (t->duration < 1 || t->duration > 3600) {
-                                printf("Invalid duration.\n");
-                            }
-                        } while (t->duration < 1 || t->duration > 3600);
-                        break;
-                    case 4:
-                        t->completed = !t->completed;
-                        printf("Status changed to: %s\n", t->completed ? "Completed" : "Pending");
-                        break;
-                    case 5:
-                        printf("Changes saved.\n");
-                        saveTasksToFile();
-                        return;
-                    default:
-                        printf("Invalid choice.\n");
-                }
-                
-            } while (choice != 5);
-            
-            return;
+    // Cache lines a pass pulls in per task
+    double recordLines = sizeof(Task) >= 64 ? 1.0 : sizeof(Task) / 64.0;
+    double columnLines[3] = {
+        sizeof(Priority) / 64.0,
+        (sizeof(int) + sizeof(bool)) / 64.0,
+        (sizeof(Priority) + sizeof(int)) / 64.0
+    };
+    const char *names[3] = {"Priority filter", "Pending count", "Sort (qsort)"};
+    
+    printf("\n=== Scan Benchmark (%d tasks, %zu-byte Task vs columns) ===\n", count, sizeof(Task));
+    printf("%-16s %12s %12s %9s %18s\n", "", "structs", "columns", "speedup", "lines/task");
+    for (int k = 0; k < 3; k++) {
+        printf("%-16s %9.2f ms %9.2f ms %8.1fx %8.3f -> %.3f\n", names[k],
+               recordTime[k] * 1e3, columnTime[k] * 1e3,
+               columnTime[k] > 0 ? recordTime[k] / columnTime[k] : 0.0,
+               recordLines, columnLines[k]);
+    }
+    (void)sink;
+    
+    free(scanRecords);
+    scanRecords = NULL;
+    free(slots);
+}
+
+// Bytes a task costs in the description arena, its share of the intern table included
+double descriptionBytesPerTask() {
+    size_t bytes = descriptionArenaUsed + (size_t)internTableCapacity * sizeof(InternEntry);
+    return taskCount > 0 ? (double)bytes / taskCount : 0.0;
+}
+
+// Description memory with a fixed 256-byte column against the interning
+// arena, first with unique descriptions, then with the generated words alone
+// so the same few thousand descriptions repeat across the task set
+void runStringBenchmark(int count) {
+    printf("Generating %d tasks...\n", count);
+    double start = monotonicSeconds();
+    generateSyntheticTasks(count);
+    double generateTime = monotonicSeconds() - start;
+    
+    size_t hotBytes = sizeof(int) + sizeof(Priority) + sizeof(int) + sizeof(time_t) + sizeof(bool);
+    size_t slotBytes = hotBytes + sizeof(unsigned int);
+    double uniqueBytes = descriptionBytesPerTask();
+    int uniqueStrings = internTableCount;
+    
+    // Drop the "#id" suffix in place; the old strings all go stale
+    start = monotonicSeconds();
+    for (int i = 0; i < taskSlotCount; i++) {
+        char description[MAX_DESCRIPTION];
+        snprintf(description, sizeof(description), "%s", taskDescription(i));
+        char *suffix = strrchr(description, '#');
+        if (suffix != NULL && suffix > description) {
+            suffix[-1] = '\0';
         }
+        releaseDescription(taskDescriptionOffsets[i]);
+        taskDescriptionOffsets[i] = internDescription(description);
     }
+    double rewriteTime = monotonicSeconds() - start;
+    trigramIndexStale = true;
+    duplicateIndexStale = true;
     
-    printf("Task with ID %d not found.\n", id);
+    size_t staleBytes = descriptionArenaStale;
+    start = monotonicSeconds();
+    compactDescriptionArena();
+    double compactTime = monotonicSeconds() - start;
+    double repeatedBytes = descriptionBytesPerTask();
+    
+    printf("\n=== String Benchmark (%d tasks) ===\n", count);
+    printf("%-30s %12s %14s %10s\n", "Layout", "bytes/task", "distinct text", "vs fixed");
+    printf("%-30s %12.1f %14s %9.1fx\n", "Fixed description column", (double)(hotBytes + MAX_DESCRIPTION), "-", 1.0);
+    printf("%-30s %12.1f %14d %9.1fx\n", "Arena, unique descriptions", slotBytes + uniqueBytes, uniqueStrings,
+           (hotBytes + MAX_DESCRIPTION) / (slotBytes + uniqueBytes));
+    printf("%-30s %12.1f %14d %9.1fx\n", "Arena, repeated descriptions", slotBytes + repeatedBytes, internTableCount,
+           (hotBytes + MAX_DESCRIPTION) / (slotBytes + repeatedBytes));
+    printf("Generate + intern: %.2f ms | re-intern %d descriptions: %.2f ms | compaction freed %.1f MB in %.2f ms\n",
+           generateTime * 1e3, taskSlotCount, rewriteTime * 1e3, staleBytes / 1e6, compactTime * 1e3);
 }
 
-// Sort tasks by priority and then duration
-void sortTasks() {
-    if (taskCount <= 1) {
-        printf("\nNothing to sort.\n");
+void sleepMicroseconds(long long micros) {
+#ifdef _WIN32
+    Sleep((DWORD)((micros + 999) / 1000));
+#else
+    struct timespec ts;
+    ts.tv_sec = micros / 1000000;
+    ts.tv_nsec = (long)(micros % 1000000) * 1000;
+    while (nanosleep(&ts, &ts) != 0) {
+    }
+#endif
+}
+
+int compareDoubles(const void *a, const void *b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Executor benchmark state: jobs sleep for their duration scaled down to
+// microseconds and record when they finished. Benchmark task IDs are their
+// index in benchmarkJobs plus one, which also holds for copies of the jobs.
+ExecutionJob *benchmarkJobs = NULL;
+double *benchmarkFinish = NULL;
+double benchmarkStart = 0.0;
+long long benchmarkMicrosPerSecond = 1;
+
+bool benchmarkRunJob(int worker, const ExecutionJob *job) {
+    (void)worker;
+    sleepMicroseconds(job->task.duration * benchmarkMicrosPerSecond);
+    benchmarkFinish[job->task.id - 1] = monotonicSeconds() - benchmarkStart;
+    return true;
+}
+
+void* waveJobThread(void *arg) {
+    benchmarkRunJob(0, (const ExecutionJob*)arg);
+    return NULL;
+}
+
+// The scheduler executeMultipleTasks() used before the worker pool: a thread
+// per task, started `width` at a time, each wave joined before the next starts
+void runWaveSchedule(ExecutionJob *jobs, int count, int width) {
+    pthread_t threads[MAX_EXECUTOR_WORKERS];
+    for (int start = 0; start < count; start += width) {
+        int wave = count - start < width ? count - start : width;
+        for (int t = 0; t < wave; t++) {
+            pthread_create(&threads[t], NULL, waveJobThread, &jobs[start + t]);
+        }
+        for (int t = 0; t < wave; t++) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+}
+
+// Makespan and completion-time percentiles, in simulated seconds, overall
+// and for the High priority tasks alone, next to the plan's prediction
+void reportSchedule(const char *name, int count, double wallTime, long long steals, long long predicted) {
+    double *high = (double*)malloc((size_t)count * sizeof(double));
+    int highCount = 0;
+    for (int i = 0; high != NULL && i < count; i++) {
+        if (benchmarkJobs[i].task.priority == HIGH) {
+            high[highCount++] = benchmarkFinish[i];
+        }
+    }
+    qsort(high, highCount, sizeof(double), compareDoubles);
+    double highP99 = highCount > 0 ? high[(int)(highCount * 0.99)] : 0.0;
+    free(high);
+    
+    qsort(benchmarkFinish, count, sizeof(double), compareDoubles);
+    double scale = 1e6 / (double)benchmarkMicrosPerSecond;
+    char planned[24] = "-";
+    if (predicted > 0) {
+        snprintf(planned, sizeof(planned), "%lld s", predicted);
+    }
+    printf("%-27s %11.0f s %11s %9.0f s %9.0f s %9.0f s %9lld\n", name, wallTime * scale, planned,
+           benchmarkFinish[count / 2] * scale, benchmarkFinish[(int)(count * 0.99)] * scale,
+           highP99 * scale, steals);
+}
+
+// Mostly short tasks with a long tail: 80% 1-10s, 15% 10-300s, 5% 300-3600s,
+// with priorities spread evenly
+void fillSkewedJobs(ExecutionJob *jobs, int count) {
+    const Priority priorities[] = {HIGH, MEDIUM, LOW};
+    benchmarkSeed = 2463534242u;
+    for (int i = 0; i < count; i++) {
+        unsigned int kind = benchmarkRandom() % 100;
+        int duration = kind < 80 ? 1 + (int)(benchmarkRandom() % 10)
+                     : kind < 95 ? 10 + (int)(benchmarkRandom() % 291)
+                     : 300 + (int)(benchmarkRandom() % 3301);
+        memset(&jobs[i], 0, sizeof(ExecutionJob));
+        jobs[i].task.id = i + 1;
+        jobs[i].task.duration = duration;
+        jobs[i].task.priority = priorities[benchmarkRandom() % 3];
+        jobs[i].slot = -1;
+    }
+}
+
+// Makespan and tail completion time of a skewed 1s-3600s duration mix under
+// the old wave scheduler and the work-stealing pool with each scheduling
+// policy, plus the priority policy with stealing turned off (each worker
+// keeps the jobs dealt to it). The wave scheduler ignored priority.
+void runExecutorBenchmark(int count) {
+    const int workers = 10;   // the old scheduler's MAX_SIMULTANEOUS_TASKS
+    benchmarkJobs = (ExecutionJob*)malloc((size_t)count * sizeof(ExecutionJob));
+    benchmarkFinish = (double*)malloc((size_t)count * sizeof(double));
+    if (benchmarkJobs == NULL || benchmarkFinish == NULL) {
+        printf("Memory allocation error\n");
+        free(benchmarkJobs);
+        free(benchmarkFinish);
         return;
     }
     
-    printf("\n=== Sort Tasks ===\n");
-    printf("1. Sort by priority (highest first)\n");
-    printf("2. Sort by duration (shortest first)\n");
-    printf("3. Sort by creation time (newest first)\n");
-    printf("Choice: ");
+    fillSkewedJobs(benchmarkJobs, count);
+    long long totalDuration = 0;
+    int longest = 0;
+    for (int i = 0; i < count; i++) {
+        totalDuration += benchmarkJobs[i].task.duration;
+        if (benchmarkJobs[i].task.duration > longest) longest = benchmarkJobs[i].task.duration;
+    }
     
-    int choice;
-    scanf("%d", &choice);
+    // Scale simulated seconds so a perfectly balanced run takes about two seconds
+    double lowerBound = (double)totalDuration / workers > longest ? (double)totalDuration / workers : longest;
+    benchmarkMicrosPerSecond = (long long)(2e6 / lowerBound);
+    if (benchmarkMicrosPerSecond < 1) benchmarkMicrosPerSecond = 1;
     
-    for (int i = 0; i < taskCount - 1; i++) {
-        for (int j = i + 1; j < taskCount; j++) {
-            bool shouldSwap = false;
-            
-            switch (choice) {
-                case 1:
-                    // By priority (then duration for ties)
-                    shouldSwap = tasks[i].priority > tasks[j].priority || 
-                                (tasks[i].priority == tasks[j].priority && 
-                                 tasks[i].duration > tasks[j].duration);
-                    break;
-                case 2:
-                    // By duration (then priority for ties)
-                    shouldSwap = tasks[i].duration > tasks[j].duration || 
-                                (tasks[i].duration == tasks[j].duration && 
-                                 tasks[i].priority > tasks[j].priority);
-                    break;
-                case 3:
-                    // By creation time (newer first)
-                    shouldSwap = tasks[i].created < tasks[j].created;
-                    break;
-                default:
-                    printf("Invalid choice. Nothing sorted.\n");
-                    return;
+    printf("\n=== Executor Benchmark (%d tasks, %d workers, %lld s of work, 1 s = %lld us) ===\n",
+           count, workers, totalDuration, benchmarkMicrosPerSecond);
+    printf("Lower bound on makespan: %.0f s\n", lowerBound);
+    printf("%-27s %13s %11s %11s %11s %11s %9s\n", "Scheduler", "makespan", "predicted", "p50 done", "p99 done",
+           "High p99", "steals");
+    
+    benchmarkStart = monotonicSeconds();
+    runWaveSchedule(benchmarkJobs, count, workers);
+    reportSchedule("Waves (old)", count, monotonicSeconds() - benchmarkStart, 0, 0);
+    
+    executor.runJob = benchmarkRunJob;
+    if (startExecutor(workers)) {
+        for (int p = 1; p <= SCHEDULE_POLICY_COUNT + 1; p++) {
+            // The extra round repeats the priority policy without stealing
+            bool pinned = p > SCHEDULE_POLICY_COUNT;
+            SchedulePolicy policy = pinned ? POLICY_PRIORITY : (SchedulePolicy)p;
+            SchedulePlan plan;
+            if (!buildSchedulePlan(&plan, benchmarkJobs, count, workers, policy, NULL)) {
+                break;
             }
-            
-            if (shouldSwap) {
-                Task temp = tasks[i];
-                tasks[i] = tasks[j];
-                tasks[j] = temp;
+            char name[32];
+            snprintf(name, sizeof(name), "Pool %s%s", policyName(policy), pinned ? ", no stealing" : "");
+            executor.stealing = !pinned;
+            benchmarkStart = monotonicSeconds();
+            executeBatch(benchmarkJobs, count, &plan, NULL, NULL);
+            reportSchedule(name, count, monotonicSeconds() - benchmarkStart, atomic_load(&executor.steals),
+                           plan.makespan);
+            freeSchedulePlan(&plan);
+        }
+        stopExecutor();
+    }
+    executor.stealing = true;
+    executor.runJob = runExecutionJob;
+    
+    free(benchmarkJobs);
+    free(benchmarkFinish);
+    benchmarkJobs = NULL;
+    benchmarkFinish = NULL;
+}
+
+// Time to plan a large batch under each policy, and the plans' quality
+void runPlanBenchmark(int count) {
+    const int workers = 16;
+    ExecutionJob *jobs = (ExecutionJob*)malloc((size_t)count * sizeof(ExecutionJob));
+    if (jobs == NULL) {
+        printf("Memory allocation error\n");
+        return;
+    }
+    fillSkewedJobs(jobs, count);
+    long long totalDuration = 0;
+    int longest = 0;
+    for (int i = 0; i < count; i++) {
+        totalDuration += jobs[i].task.duration;
+        if (jobs[i].task.duration > longest) longest = jobs[i].task.duration;
+    }
+    long long lowerBound = (totalDuration + workers - 1) / workers;
+    if (longest > lowerBound) lowerBound = longest;
+    
+    printf("\n=== Plan Benchmark (%d tasks, %d workers, lower bound %lld s) ===\n", count, workers, lowerBound);
+    printf("%-10s %10s %14s %10s %16s %16s\n", "Policy", "plan time", "makespan", "vs bound", "mean completion",
+           "last High done");
+    for (int p = 1; p <= SCHEDULE_POLICY_COUNT; p++) {
+        SchedulePlan plan;
+        double start = monotonicSeconds();
+        if (!buildSchedulePlan(&plan, jobs, count, workers, (SchedulePolicy)p, NULL)) {
+            break;
+        }
+        double elapsed = monotonicSeconds() - start;
+        printf("%-10s %7.1f ms %12lld s %9.4fx %14.0f s %14lld s\n", policyName(plan.policy), elapsed * 1e3,
+               plan.makespan, (double)plan.makespan / lowerBound, plan.meanCompletion, plan.highMakespan);
+        freeSchedulePlan(&plan);
+    }
+    
+    // The same tasks with dependencies: building the graph plus planning
+    int *from = (int*)malloc((size_t)count * 2 * sizeof(int));
+    int *to = (int*)malloc((size_t)count * 2 * sizeof(int));
+    if (from != NULL && to != NULL) {
+        int edgeCount = fillRandomDependencies(count, from, to);
+        JobGraph graph;
+        SchedulePlan plan;
+        double start = monotonicSeconds();
+        if (buildJobGraphFromEdges(&graph, jobs, count, from, to, edgeCount)) {
+            if (buildSchedulePlan(&plan, jobs, count, workers, POLICY_LPT, &graph)) {
+                double elapsed = monotonicSeconds() - start;
+                long long bound = graph.criticalLength > lowerBound ? graph.criticalLength : lowerBound;
+                printf("%-10s %7.1f ms %12lld s %9.4fx %14.0f s %14lld s  (%d dependencies, critical path %lld s)\n",
+                       "LPT + deps", elapsed * 1e3, plan.makespan, (double)plan.makespan / bound,
+                       plan.meanCompletion, plan.highMakespan, edgeCount, graph.criticalLength);
+                freeSchedulePlan(&plan);
+            }
+            freeJobGraph(&graph);
+        }
+    } else {
+        printf("Memory allocation error\n");
+    }
+    free(from);
+    free(to);
+    free(jobs);
+}
+
+// Random acyclic dependencies for a benchmark batch: most jobs wait on one
+// or two of the 64 jobs before them. Edges always point forward, so there is
+// no cycle. Returns the number of edges; from and to hold up to 2 * count.
+int fillRandomDependencies(int count, int *from, int *to) {
+    int edgeCount = 0;
+    for (int j = 1; j < count; j++) {
+        unsigned int kind = benchmarkRandom() % 100;
+        int edges = kind < 30 ? 0 : kind < 80 ? 1 : 2;
+        int window = j < 64 ? j : 64;
+        int previous = -1;
+        for (int e = 0; e < edges; e++) {
+            int prerequisite = j - 1 - (int)(benchmarkRandom() % (unsigned int)window);
+            if (prerequisite != previous) {
+                from[edgeCount] = prerequisite;
+                to[edgeCount] = j;
+                edgeCount++;
+                previous = prerequisite;
             }
         }
     }
-    
-    printf("Tasks sorted successfully.\n");
-    viewTasks();
+    return edgeCount;
 }
 
-// Thread function to execute a single task
-void* executeTaskThread(void* arg) {
-    ThreadArgs* args = (ThreadArgs*)arg;
-    Task* task = args->task;
-    int* isRunning = args->isRunning;
-    int taskIndex = args->taskIndex;
-    
-    printf("\n[Thread %d] Executing: %s (ID: %d) | Priority: %s | Duration: %d sec\n",
-           taskIndex + 1, task->description, task->id, 
-           priorityToString(task->priority), task->duration);
-    
-    // Countdown timer
-    for (int j = task->duration; j > 0; j--) {
-        if (!(*isRunning)) {
-            printf("\n[Thread %d] Task execution cancelled.\n", taskIndex + 1);
-            pthread_exit(NULL);
+// Run benchmarkJobs one dependency level at a time, each level a batch that
+// waits for its slowest job before the next starts. Returns the steals.
+long long runLevelBarriers(int count, const int *level, int levels, ExecutionJob *levelJobs) {
+    long long steals = 0;
+    for (int l = 0; l < levels; l++) {
+        int levelCount = 0;
+        for (int j = 0; j < count; j++) {
+            if (level[j] == l) {
+                levelJobs[levelCount++] = benchmarkJobs[j];
+            }
         }
-        
-        printf("\r[Thread %d] Time remaining: %d seconds...   ", taskIndex + 1, j);
-        fflush(stdout);
-        sleep(1);  // Simulate execution
+        SchedulePlan plan;
+        if (!buildSchedulePlan(&plan, levelJobs, levelCount, executor.workerCount, POLICY_LPT, NULL)) {
+            break;
+        }
+        executeBatch(levelJobs, levelCount, &plan, NULL, NULL);
+        steals += atomic_load(&executor.steals);
+        freeSchedulePlan(&plan);
     }
-    
-    task->completed = true;
-    printf("\r[Thread %d] Task %d completed!                  \n", taskIndex + 1, task->id);
-    
-    free(args);
-    pthread_exit(NULL);
+    return steals;
 }
 
-// Execute all pending tasks simultaneously (or up to MAX_SIMULTANEOUS_TASKS)
-void executeMultipleTasks() {
-    if (taskCount == 0) {
-        printf("\nNo tasks to execute.\n");
-        return;
+// A batch with dependencies run by releasing each job the moment its last
+// prerequisite finishes, against running it one dependency level at a time
+// with a barrier between levels
+void runDagBenchmark(int count) {
+    const int workers = 10;
+    benchmarkJobs = (ExecutionJob*)malloc((size_t)count * sizeof(ExecutionJob));
+    benchmarkFinish = (double*)malloc((size_t)count * sizeof(double));
+    ExecutionJob *levelJobs = (ExecutionJob*)malloc((size_t)count * sizeof(ExecutionJob));
+    int *from = (int*)malloc((size_t)count * 2 * sizeof(int));
+    int *to = (int*)malloc((size_t)count * 2 * sizeof(int));
+    int *level = (int*)calloc((size_t)count, sizeof(int));
+    JobGraph graph;
+    bool ready = benchmarkJobs != NULL && benchmarkFinish != NULL && levelJobs != NULL &&
+                 from != NULL && to != NULL && level != NULL;
+    if (!ready) {
+        printf("Memory allocation error\n");
     }
     
-    // Count pending tasks
-    int pendingCount = 0;
-    int pendingTaskIds[MAX_TASKS];
-    
-    printf("\n=== Pending Tasks ===\n");
+    int edgeCount = 0;
+    double graphTime = 0.0;
+    if (ready) {
+        fillSkewedJobs(benchmarkJobs, count);
+        edgeCount = fillRandomDependencies(count, from, to);
+        double start = monotonicSeconds();
+        ready = buildJobGraphFromEdges(&graph, benchmarkJobs, count, from, to, edgeCount);
+        graphTime = monotonicSeconds() - start;
+    }
     
-    for (int i = 0; i < taskCount; i++) {
-        if (!tasks[i].completed) {
-            pendingTaskIds[pendingCount++] = tasks[i].id;
-            printf("%d: %s (%s, %d sec)\n", 
-                   tasks[i].id, 
-                   tasks[i].description, 
-                   priorityToString(tasks[i].priority),
-                   tasks[i].duration);
+    if (ready) {
+        // Edges point forward and were made in job order, so one pass finds every level
+        int levels = 0;
+        for (int e = 0; e < edgeCount; e++) {
+            if (level[from[e]] + 1 > level[to[e]]) {
+                level[to[e]] = level[from[e]] + 1;
+            }
+        }
+        long long totalDuration = 0;
+        for (int j = 0; j < count; j++) {
+            totalDuration += benchmarkJobs[j].task.duration;
+            if (level[j] + 1 > levels) levels = level[j] + 1;
+        }
+        double lowerBound = (double)totalDuration / workers > graph.criticalLength ?
+                            (double)totalDuration / workers : (double)graph.criticalLength;
+        benchmarkMicrosPerSecond = (long long)(2e6 / lowerBound);
+        if (benchmarkMicrosPerSecond < 1) benchmarkMicrosPerSecond = 1;
+        
+        printf("\n=== Dependency Benchmark (%d tasks, %d dependencies, %d levels, %d workers, 1 s = %lld us) ===\n",
+               count, edgeCount, levels, workers, benchmarkMicrosPerSecond);
+        printf("Work / workers: %.0f s | critical path: %lld s through %d tasks | graph built in %.2f ms\n",
+               (double)totalDuration / workers, graph.criticalLength, graph.criticalCount, graphTime * 1e3);
+        printf("%-27s %13s %11s %11s %11s %11s %9s\n", "Scheduler", "makespan", "predicted", "p50 done",
+               "p99 done", "High p99", "steals");
+        
+        executor.runJob = benchmarkRunJob;
+        if (startExecutor(workers)) {
+            benchmarkStart = monotonicSeconds();
+            long long steals = runLevelBarriers(count, level, levels, levelJobs);
+            reportSchedule("Level barriers (LPT)", count, monotonicSeconds() - benchmarkStart, steals, 0);
+            
+            SchedulePolicy policies[] = {POLICY_FIFO, POLICY_PRIORITY, POLICY_LPT};
+            for (int p = 0; p < 3; p++) {
+                SchedulePlan plan;
+                if (!buildSchedulePlan(&plan, benchmarkJobs, count, workers, policies[p], &graph)) {
+                    break;
+                }
+                char name[32];
+                snprintf(name, sizeof(name), "Release on finish (%s)", policyName(policies[p]));
+                benchmarkStart = monotonicSeconds();
+                executeBatch(benchmarkJobs, count, &plan, &graph, NULL);
+                reportSchedule(name, count, monotonicSeconds() - benchmarkStart, atomic_load(&executor.steals),
+                               plan.makespan);
+                freeSchedulePlan(&plan);
+            }
+            stopExecutor();
         }
+        executor.runJob = runExecutionJob;
+        freeJobGraph(&graph);
     }
     
-    if (pendingCount == 0) {
-        printf("No pending tasks to execute.\n");
+    free(benchmarkJobs);
+    free(benchmarkFinish);
+    free(levelJobs);
+    free(from);
+    free(to);
+    free(level);
+    benchmarkJobs = NULL;
+    benchmarkFinish = NULL;
+}
+
+// Timer benchmark events: benchmarkFinish holds the tick each job finished on
+void recordTimerFinish(const ExecutionJob *jobs, int job, long long tick, bool finished) {
+    if (finished) {
+        benchmarkFinish[jobs[job].task.id - 1] = (double)tick;
+    }
+}
+
+// A skewed batch with a tenth of it running at once, far past what a thread
+// per running task allows, counted down by the timer wheel on one thread:
+// paced so the run takes about two seconds, then unpaced to show the
+// engine's own cost. Every task should finish on the tick the plan predicts.
+void runTimerBenchmark(int count) {
+    int slots = count / 10 > 0 ? count / 10 : 1;
+    if (slots > MAX_TIMER_SLOTS) slots = MAX_TIMER_SLOTS;
+    benchmarkJobs = (ExecutionJob*)malloc((size_t)count * sizeof(ExecutionJob));
+    benchmarkFinish = (double*)malloc((size_t)count * sizeof(double));
+    if (benchmarkJobs == NULL || benchmarkFinish == NULL) {
+        printf("Memory allocation error\n");
+        free(benchmarkJobs);
+        free(benchmarkFinish);
+        benchmarkJobs = NULL;
+        benchmarkFinish = NULL;
         return;
     }
+    fillSkewedJobs(benchmarkJobs, count);
     
-    // Task selection
-    char taskSelection[MAX_TASKS * 4]; // Allow for IDs up to 999 with commas
-    bool selectedTasks[MAX_TASKS] = {false};
-    int numSelected = 0;
-    
-    printf("\nSelect tasks to execute (enter IDs separated by commas, or 'all' for all tasks): ");
-    clearInputBuffer();
-    fgets(taskSelection, sizeof(taskSelection), stdin);
-    
-    // Remove newline
-    taskSelection[strcspn(taskSelection, "\n")] = 0;
-    
-    // Check if user wants all tasks
-    if (strcmp(taskSelection, "all") == 0) {
-        for (int i = 0; i < pendingCount; i++) {
-            for (int j = 0; j < taskCount; j++) {
-                if (tasks[j].id == pendingTaskIds[i] && !tasks[j].completed) {
-                    selectedTasks[j] = true;
-                    numSelected++;
+    SchedulePlan plan;
+    SchedulePlan poolPlan;
+    if (buildSchedulePlan(&plan, benchmarkJobs, count, slots, POLICY_PRIORITY, NULL)) {
+        if (buildSchedulePlan(&poolPlan, benchmarkJobs, count, MAX_EXECUTOR_WORKERS, POLICY_PRIORITY, NULL)) {
+            long long paced = plan.makespan > 0 ? (long long)(2e6 / plan.makespan) : 1;
+            if (paced < 1) paced = 1;
+            
+            printf("\n=== Timer Wheel Benchmark (%d tasks, up to %d running at once, 1 engine thread) ===\n",
+                   count, slots);
+            printf("Planned makespan: %lld s | on a pool of %d threads: %lld s\n",
+                   plan.makespan, MAX_EXECUTOR_WORKERS, poolPlan.makespan);
+            printf("%-22s %12s %10s %12s %14s %16s %15s\n", "Run", "makespan", "wall time", "engine CPU",
+                   "CPU per tick", "CPU/completion", "on plan");
+            
+            long long tickMicros[2] = {paced, 0};
+            for (int r = 0; r < 2; r++) {
+                for (int j = 0; j < count; j++) {
+                    benchmarkFinish[j] = -1.0;
                 }
-            }
-        }
-    } else {
-        // Parse comma-separated IDs
-        char *token = strtok(taskSelection, " ,");
-        while (token != NULL) {
-            int id = atoi(token);
-            if (id > 0) {
-                for (int i = 0; i < taskCount; i++) {
-                    if (tasks[i].id == id && !tasks[i].completed) {
-                        selectedTasks[i] = true;
-                        numSelected++;
-                        break;
+                clock_t cpuStart = clock();
+                double start = monotonicSeconds();
+                long long makespan = runTimerEngine(benchmarkJobs, count, slots, POLICY_PRIORITY, NULL,
+                                                    tickMicros[r], recordTimerFinish);
+                double wallTime = monotonicSeconds() - start;
+                double cpuTime = (double)(clock() - cpuStart) / CLOCKS_PER_SEC;
+                if (makespan < 0) {
+                    break;
+                }
+                
+                int onPlan = 0;
+                for (int j = 0; j < count; j++) {
+                    if (benchmarkFinish[j] == (double)(plan.start[j] + benchmarkJobs[j].task.duration)) {
+                        onPlan++;
                     }
                 }
+                char name[40];
+                if (tickMicros[r] > 0) {
+                    snprintf(name, sizeof(name), "Paced, 1 s = %lld us", tickMicros[r]);
+                } else {
+                    snprintf(name, sizeof(name), "Unpaced");
+                }
+                printf("%-22s %10lld s %8.2f s %9.1f ms %11.3f us %13.3f us %8d/%d\n", name, makespan, wallTime,
+                       cpuTime * 1e3, makespan > 0 ? cpuTime * 1e6 / makespan : 0.0, cpuTime * 1e6 / count,
+                       onPlan, count);
             }
-            token = strtok(NULL, " ,");
+            freeSchedulePlan(&poolPlan);
         }
+        freeSchedulePlan(&plan);
     }
     
-    if (numSelected == 0) {
-        printf("No valid tasks selected.\n");
+    free(benchmarkJobs);
+    free(benchmarkFinish);
+    benchmarkJobs = NULL;
+    benchmarkFinish = NULL;
+}
+
+// Virtual-time simulation of a large batch on 16 workers: completions
+// simulated per second under each policy, with and without dependencies,
+// a capacity plan over worker counts, and a check against the timer wheel
+// that every task finishes when the simulation says
+void runSimulateBenchmark(int count) {
+    const int workers = 16;
+    benchmarkJobs = (ExecutionJob*)malloc((size_t)count * sizeof(ExecutionJob));
+    benchmarkFinish = (double*)malloc((size_t)count * sizeof(double));
+    int *from = (int*)malloc((size_t)count * 2 * sizeof(int));
+    int *to = (int*)malloc((size_t)count * 2 * sizeof(int));
+    if (benchmarkJobs == NULL || benchmarkFinish == NULL || from == NULL || to == NULL) {
+        printf("Memory allocation error\n");
+        free(benchmarkJobs);
+        free(benchmarkFinish);
+        free(from);
+        free(to);
+        benchmarkJobs = NULL;
+        benchmarkFinish = NULL;
         return;
     }
+    fillSkewedJobs(benchmarkJobs, count);
     
-    // Create threads (up to MAX_SIMULTANEOUS_TASKS)
-    int maxThreads = (numSelected < MAX_SIMULTANEOUS_TASKS) ? numSelected : MAX_SIMULTANEOUS_TASKS;
-    pthread_t threads[MAX_SIMULTANEOUS_TASKS];
-    int runningThreads = 0;
-    int isRunning = 1; // Flag to control thread execution
-    int tasksDone = 0;
-    
-    printf("\nExecuting %d tasks with up to %d running simultaneously.\n", numSelected, maxThreads);
-    printf("Press Enter to start execution or Ctrl+C to cancel...");
-    getchar();
-    
-    time_t startTime = time(NULL);
+    printf("\n=== Simulation Benchmark (%d tasks, %d workers) ===\n", count, workers);
+    printf("%-12s %12s %16s %14s\n", "Policy", "simulated in", "completions/s", "total time");
+    SchedulePlan checked;
+    bool haveChecked = false;
+    for (int p = 1; p <= SCHEDULE_POLICY_COUNT + 1; p++) {
+        // The extra round adds random dependencies under LPT
+        bool withDependencies = p > SCHEDULE_POLICY_COUNT;
+        SchedulePolicy policy = withDependencies ? POLICY_LPT : (SchedulePolicy)p;
+        JobGraph graph;
+        SchedulePlan plan;
+        double start = monotonicSeconds();
+        if (withDependencies) {
+            int edgeCount = fillRandomDependencies(count, from, to);
+            if (!buildJobGraphFromEdges(&graph, benchmarkJobs, count, from, to, edgeCount)) {
+                break;
+            }
+        }
+        bool planned = buildSchedulePlan(&plan, benchmarkJobs, count, workers, policy,
+                                         withDependencies ? &graph : NULL);
+        int *completed = planned ? completionOrder(&plan, benchmarkJobs) : NULL;
+        double elapsed = monotonicSeconds() - start;
+        if (withDependencies) {
+            freeJobGraph(&graph);
+        }
+        if (completed == NULL) {
+            if (planned) {
+                freeSchedulePlan(&plan);
+            }
+            break;
+        }
+        free(completed);
+        
+        printf("%-12s %9.1f ms %16.0f %12lld s\n", withDependencies ? "LPT + deps" : policyName(policy),
+               elapsed * 1e3, count / elapsed, plan.makespan);
+        if (policy == POLICY_PRIORITY && !withDependencies) {
+            checked = plan;
+            haveChecked = true;
+        } else {
+            freeSchedulePlan(&plan);
+        }
+    }
     
-    // Initialize and create threads
-    for (int i = 0; i < taskCount && runningThreads < maxThreads; i++) {
-        if (selectedTasks[i]) {
-            ThreadArgs *args = (ThreadArgs*)malloc(sizeof(ThreadArgs));
-            if (args == NULL) {
-                printf("Memory allocation error\n");
-                return;
+    if (haveChecked) {
+        printf("\nCapacity plan (Priority):");
+        double start = monotonicSeconds();
+        sweepWorkerCounts(benchmarkJobs, count, POLICY_PRIORITY, NULL);
+        printf("Swept in %.1f ms\n", (monotonicSeconds() - start) * 1e3);
+        
+        start = monotonicSeconds();
+        long long makespan = runTimerEngine(benchmarkJobs, count, workers, POLICY_PRIORITY, NULL, 0,
+                                            recordTimerFinish);
+        double elapsed = monotonicSeconds() - start;
+        if (makespan >= 0) {
+            int matched = 0;
+            for (int j = 0; j < count; j++) {
+                if (benchmarkFinish[j] == (double)(checked.start[j] + benchmarkJobs[j].task.duration)) {
+                    matched++;
+                }
             }
-            
-            args->task = &tasks[i];
-            args->isRunning = &isRunning;
-            args->taskIndex = runningThreads;
-            
-            pthread_create(&threads[runningThreads], NULL, executeTaskThread, (void*)args);
-            runningThreads++;
-            tasksDone++;
+            printf("\nTimer wheel run (Priority, unpaced): total time %lld s (simulated %lld s) in %.1f ms, "
+                   "%d/%d tasks finished as simulated\n", makespan, checked.makespan, elapsed * 1e3, matched, count);
         }
+        freeSchedulePlan(&checked);
     }
     
-    // Wait for threads to finish and start new ones as needed
-    int nextTaskToRun = 0;
-    while (tasksDone < numSelected) {
-        // Find the next task to run
-        for (int i = nextTaskToRun; i < taskCount; i++) {
-            if (selectedTasks[i] && !tasks[i].completed) {
-                nextTaskToRun = i + 1;
-                break;
+    free(benchmarkJobs);
+    free(benchmarkFinish);
+    free(from);
+    free(to);
+    benchmarkJobs = NULL;
+    benchmarkFinish = NULL;
+}
+
+// Completion stress state: how often each job ran, and the run after which
+// the cancelling round asks the batch to stop (0 for never)
+_Atomic int *stressRuns = NULL;
+_Atomic int stressRunTotal;
+int stressCancelAfter = 0;
+
+bool stressRunJob(int worker, const ExecutionJob *job) {
+    (void)worker;
+    atomic_fetch_add_explicit(&stressRuns[job->task.id - 1], 1, memory_order_relaxed);
+    if (atomic_fetch_add(&stressRunTotal, 1) + 1 == stressCancelAfter) {
+        requestCancel(&executionCancel);
+    }
+    return true;
+}
+
+// Check a stress round: no job ran twice, the log holds every job that ran
+// exactly once, and no job completed before a job it waits on. Returns the
+// first problem found, or NULL.
+const char* checkCompletions(int count, CompletionLog *log, const JobGraph *graph, int *position) {
+    int completed = atomic_load(&log->claimed);
+    int ran = 0;
+    for (int j = 0; j < count; j++) {
+        int runs = atomic_load(&stressRuns[j]);
+        if (runs > 1) {
+            return "a job ran twice";
+        }
+        ran += runs;
+        position[j] = -1;
+    }
+    if (completed != ran) {
+        return "completions lost or invented";
+    }
+    for (int n = 0; n < completed; n++) {
+        int j = completionLogRead(log, n);
+        if (j < 0 || j >= count || position[j] >= 0 || atomic_load(&stressRuns[j]) != 1) {
+            return "bad completion log entry";
+        }
+        position[j] = n;
+    }
+    for (int j = 0; graph != NULL && j < count; j++) {
+        for (int k = graph->successorStart[j]; k < graph->successorStart[j + 1]; k++) {
+            int s = graph->successors[k];
+            if (position[s] >= 0 && (position[j] < 0 || position[j] > position[s])) {
+                return "a job completed before its prerequisite";
             }
         }
-        
-        // Wait for any thread to finish
-        for (int i = 0; i < runningThreads; i++) {
-            pthread_join(threads[i], NULL);
+    }
+    return NULL;
+}
+
+// Many workers completing jobs that do no work, so every completion races
+// with others: independent jobs, jobs with dependencies, and the same
+// cancelled half way. Each round is checked job by job. Meant to be run
+// under ThreadSanitizer too.
+void runCompletionBenchmark(int count) {
+    const int workers = 8;
+    benchmarkJobs = (ExecutionJob*)malloc((size_t)count * sizeof(ExecutionJob));
+    stressRuns = (_Atomic int*)malloc((size_t)count * sizeof(_Atomic int));
+    int *position = (int*)malloc((size_t)count * sizeof(int));
+    int *from = (int*)malloc((size_t)count * 2 * sizeof(int));
+    int *to = (int*)malloc((size_t)count * 2 * sizeof(int));
+    CompletionLog completions;
+    JobGraph graph;
+    bool ready = benchmarkJobs != NULL && stressRuns != NULL && position != NULL && from != NULL && to != NULL;
+    if (!ready) {
+        printf("Memory allocation error\n");
+    } else {
+        fillSkewedJobs(benchmarkJobs, count);
+        ready = completionLogInit(&completions, count);
+    }
+    if (ready) {
+        int edgeCount = fillRandomDependencies(count, from, to);
+        ready = buildJobGraphFromEdges(&graph, benchmarkJobs, count, from, to, edgeCount);
+        if (!ready) {
+            completionLogFree(&completions);
         }
+    }
+    
+    if (ready) {
+        printf("\n=== Completion Stress (%d tasks, %d workers) ===\n", count, workers);
+        printf("%-22s %10s %10s %10s %14s  %s\n", "Round", "completed", "cancelled", "time", "completions/s", "check");
         
-        // Start new threads for remaining tasks
-        runningThreads = 0;
-        for (int i = nextTaskToRun; i < taskCount && runningThreads < maxThreads; i++) {
-            if (selectedTasks[i] && !tasks[i].completed) {
-                ThreadArgs *args = (ThreadArgs*)malloc(sizeof(ThreadArgs));
-                if (args == NULL) {
-                    printf("Memory allocation error\n");
-                    return;
+        executor.runJob = stressRunJob;
+        if (startExecutor(workers)) {
+            for (int round = 0; round < 3; round++) {
+                const JobGraph *roundGraph = round > 0 ? &graph : NULL;
+                const char *name = round == 0 ? "Independent" : round == 1 ? "With dependencies" : "Cancelled half way";
+                SchedulePlan plan;
+                if (!buildSchedulePlan(&plan, benchmarkJobs, count, workers, POLICY_PRIORITY, roundGraph)) {
+                    break;
                 }
+                for (int j = 0; j < count; j++) {
+                    atomic_init(&stressRuns[j], 0);
+                    atomic_init(&completions.entries[j], -1);
+                }
+                atomic_store(&completions.claimed, 0);
+                atomic_store(&stressRunTotal, 0);
+                atomic_store(&executionCancel.requested, false);
+                stressCancelAfter = round == 2 ? count / 2 : 0;
                 
-                args->task = &tasks[i];
-                args->isRunning = &isRunning;
-                args->taskIndex = runningThreads;
-                
-                pthread_create(&threads[runningThreads], NULL, executeTaskThread, (void*)args);
-                runningThreads++;
-                tasksDone++;
+                double start = monotonicSeconds();
+                executeBatch(benchmarkJobs, count, &plan, roundGraph, &completions);
+                double elapsed = monotonicSeconds() - start;
                 
-                if (tasksDone >= numSelected) {
-                    break;
+                const char *problem = checkCompletions(count, &completions, roundGraph, position);
+                int completed = atomic_load(&completions.claimed);
+                if (problem == NULL && round < 2 && completed != count) {
+                    problem = "jobs left unfinished";
                 }
+                printf("%-22s %10d %10d %7.1f ms %14.0f  %s\n", name, completed, count - completed, elapsed * 1e3,
+                       completed / elapsed, problem != NULL ? problem : "OK");
+                freeSchedulePlan(&plan);
             }
+            stopExecutor();
         }
+        atomic_store(&executionCancel.requested, false);
+        executor.runJob = runExecutionJob;
+        freeJobGraph(&graph);
+        completionLogFree(&completions);
     }
     
-    // Wait for any remaining threads
-    for (int i = 0; i < runningThreads; i++) {
-        pthread_join(threads[i], NULL);
+    free(benchmarkJobs);
+    free(stressRuns);
+    free(position);
+    free(from);
+    free(to);
+    benchmarkJobs = NULL;
+    stressRuns = NULL;
+}
+
+// The obvious durable executor: each worker journals its completion and
+// fsyncs before taking the next job
+pthread_mutex_t benchmarkJournalLock = PTHREAD_MUTEX_INITIALIZER;
+int benchmarkSyncs = 0;
+
+bool syncedRunJob(int worker, const ExecutionJob *job) {
+    stressRunJob(worker, job);
+    pthread_mutex_lock(&benchmarkJournalLock);
+    journalCompletionRecord(job->task.id, true);
+    journalSync();
+    benchmarkSyncs++;
+    pthread_mutex_unlock(&benchmarkJournalLock);
+    return true;
+}
+
+// Completion throughput of 8 workers on jobs that do no work, with nothing
+// persisted, with group commits, and with an fsync per completion (run on at
+// most 2000 jobs, since it is slow). Uses a temporary bench_commit.journal.
+void runCommitBenchmark(int count) {
+    const int workers = 8;
+    const char *path = "bench_commit.journal";
+    benchmarkJobs = (ExecutionJob*)malloc((size_t)count * sizeof(ExecutionJob));
+    stressRuns = (_Atomic int*)malloc((size_t)count * sizeof(_Atomic int));
+    CompletionLog completions;
+    bool ready = benchmarkJobs != NULL && stressRuns != NULL;
+    if (!ready) {
+        printf("Memory allocation error\n");
+    } else {
+        ready = completionLogInit(&completions, count);
+    }
+    FILE *savedJournal = journalFile;
+    int savedRecords = journalRecords;
+    if (ready) {
+        journalFile = fopen(path, "wb");
+        if (journalFile == NULL) {
+            printf("Error: Cannot open %s for writing.\n", path);
+            completionLogFree(&completions);
+            ready = false;
+        }
     }
     
-    time_t endTime = time(NULL);
-    printf("\n=== Execution Summary ===\n");
-    printf("Tasks completed: %d\n", numSelected);
-    printf("Total wall clock time: %ld seconds\n", (endTime - startTime));
+    if (ready) {
+        fillSkewedJobs(benchmarkJobs, count);
+        printf("\n=== Group Commit Benchmark (%d workers, commit at %d waiting or every %d ms) ===\n", workers,
+               GROUP_COMMIT_RECORDS, GROUP_COMMIT_INTERVAL_MS);
+        printf("%-22s %10s %10s %14s %8s %14s %10s\n", "Persistence", "completed", "time", "completions/s", "fsyncs",
+               "records/fsync", "journaled");
+        
+        startExecutor(workers);
+        for (int round = 0; round < 3 && executor.workerCount > 0; round++) {
+            int jobs = round == 2 && count > 2000 ? 2000 : count;
+            SchedulePlan plan;
+            if (!buildSchedulePlan(&plan, benchmarkJobs, jobs, workers, POLICY_FIFO, NULL)) {
+                break;
+            }
+            for (int j = 0; j < jobs; j++) {
+                atomic_init(&stressRuns[j], 0);
+                atomic_init(&completions.entries[j], -1);
+            }
+            atomic_store(&completions.claimed, 0);
+            stressCancelAfter = 0;
+            benchmarkSyncs = 0;
+            journalRecords = 0;
+            executor.runJob = round == 2 ? syncedRunJob : stressRunJob;
+            
+            GroupCommit commit;
+            commit.groups = 0;
+            double start = monotonicSeconds();
+            bool committing = round == 1 && startGroupCommit(&commit, &completions, benchmarkJobs);
+            executeBatch(benchmarkJobs, jobs, &plan, NULL, &completions);
+            if (committing) {
+                stopGroupCommit(&commit);
+            }
+            double elapsed = monotonicSeconds() - start;
+            
+            int completed = atomic_load(&completions.claimed);
+            int syncs = round == 1 ? commit.groups : benchmarkSyncs;
+            const char *name = round == 0 ? "None" : round == 1 ? "Group commit" : "fsync per completion";
+            printf("%-22s %10d %7.1f ms %14.0f %8d %14.1f %10d\n", name, completed, elapsed * 1e3,
+                   completed / elapsed, syncs, syncs > 0 ? (double)journalRecords / syncs : 0.0, journalRecords);
+            freeSchedulePlan(&plan);
+        }
+        stopExecutor();
+        executor.runJob = runExecutionJob;
+        fclose(journalFile);
+        remove(path);
+        completionLogFree(&completions);
+    }
+    journalFile = savedJournal;
+    journalRecords = savedRecords;
     
-    saveTasksToFile();
+    free(benchmarkJobs);
+    free(stressRuns);
+    benchmarkJobs = NULL;
+    stressRuns = NULL;
 }
 
-// Execute a specific task
-void executeSpecificTask() {
-    if (taskCount == 0) {
-        printf("\nNo tasks available to execute.\n");
+// Bulk import through the command-line path, flushed once, against adding
+// the same records one at a time with a sync each as the menu does (at most
+// 2000, since that is slow). Uses temporary bench_import.txt and
+// bench_import.journal files.
+void runImportBenchmark(int count) {
+    const char *recordPath = "bench_import.txt";
+    const char *journalPath = "bench_import.journal";
+    
+    generateSyntheticTasks(count);
+    FILE *records = fopen(recordPath, "w");
+    if (records == NULL) {
+        printf("Error: Cannot open %s for writing.\n", recordPath);
+        resetTaskStore();
         return;
     }
+    for (int i = 0; i < taskSlotCount; i++) {
+        fprintf(records, "%s %d %s\n", priorityToString(taskPriorities[i]), taskDurations[i], taskDescription(i));
+    }
+    fclose(records);
     
-    printf("\n=== Execute Specific Task ===\n");
+    FILE *savedJournal = journalFile;
+    int savedRecords = journalRecords;
+    printf("\n=== Import Benchmark (%d records) ===\n", count);
+    double elapsed[2] = {0, 0}, flushed[2] = {0, 0};
+    int added[2] = {0, 0};
     
-    // Display only pending tasks
-    printf("Pending tasks:\n");
-    int pendingCount = 0;
-    for (int i = 0; i < taskCount; i++) {
-        if (!tasks[i].completed) {
-            printf("%d: %s (%s, %d sec)\n", 
-                   tasks[i].id, 
-                   tasks[i].description, 
-                   priorityToString(tasks[i].priority),
-                   tasks[i].duration);
-            pendingCount++;
+    for (int round = 0; round < 2; round++) {
+        int limit = round == 1 && count > 2000 ? 2000 : count;
+        resetTaskStore();
+        journalFile = fopen(journalPath, "wb");
+        journalRecords = 0;
+        records = fopen(recordPath, "r");
+        if (journalFile == NULL || records == NULL) {
+            printf("Error: Cannot open %s.\n", journalFile == NULL ? journalPath : recordPath);
+            break;
         }
+        setvbuf(records, NULL, _IOFBF, STREAM_BUFFER_SIZE);
+        
+        double start = monotonicSeconds();
+        double syncTime = 0;
+        if (round == 0) {
+            importTasks(records, recordPath, FORMAT_TEXT, false);
+            double syncStart = monotonicSeconds();
+            journalSync();
+            syncTime = monotonicSeconds() - syncStart;
+        } else {
+            char line[TASK_LINE_MAX];
+            for (int n = 0; n < limit && fgets(line, sizeof(line), records) != NULL; n++) {
+                Task t;
+                bool isNew;
+                if (parseTaskRecord(line, &t) != NULL || !addTaskRecord(&t, false, &isNew)) {
+                    break;
+                }
+                double syncStart = monotonicSeconds();
+                journalSync();
+                syncTime += monotonicSeconds() - syncStart;
+            }
+        }
+        elapsed[round] = monotonicSeconds() - start;
+        flushed[round] = syncTime;
+        added[round] = taskCount;
+        fclose(records);
+        fclose(journalFile);
     }
     
-    if (pendingCount == 0) {
-        printf("No pending tasks to execute.\n");
+    printf("%-26s %10s %12s %10s %14s\n", "Path", "tasks", "load+index", "flush", "tasks/s");
+    for (int round = 0; round < 2; round++) {
+        printf("%-26s %10d %9.1f ms %7.1f ms %14.0f\n", round == 0 ? "Import, one flush" : "Add, fsync per task",
+               added[round], (elapsed[round] - flushed[round]) * 1e3, flushed[round] * 1e3,
+               elapsed[round] > 0 ? added[round] / elapsed[round] : 0.0);
+    }
+    journalFile = savedJournal;
+    journalRecords = savedRecords;
+    remove(recordPath);
+    remove(journalPath);
+    resetTaskStore();
+}
+
+// Export and streaming import of each line format, next to plain reads of
+// the same file for the bandwidth they could reach. Uses temporary
+// bench_formats.* files.
+void runFormatBenchmark(int count) {
+    const char *paths[RECORD_FORMAT_COUNT] = {"bench_formats.txt", "bench_formats.csv", "bench_formats.jsonl"};
+    const char *journalPath = "bench_formats.journal";
+    double exportTime[RECORD_FORMAT_COUNT], importTime[RECORD_FORMAT_COUNT], readTime[RECORD_FORMAT_COUNT];
+    double parseTime[RECORD_FORMAT_COUNT];
+    long long bytes[RECORD_FORMAT_COUNT];
+    int imported[RECORD_FORMAT_COUNT];
+    unsigned char *buffer = (unsigned char*)malloc(STREAM_BUFFER_SIZE);
+    if (buffer == NULL) {
+        printf("Memory allocation error\n");
         return;
     }
     
-    printf("\nEnter task ID to execute (or 0 to cancel): ");
-    int id;
-    scanf("%d", &id);
-    
-    if (id == 0) return;
-    
-    // Find and execute the task
-    for (int i = 0; i < taskCount; i++) {
-        if (tasks[i].id == id && !tasks[i].completed) {
-            printf("\nExecuting: %s (ID: %d) | Priority: %s | Duration: %d sec\n",
-                   tasks[i].description, tasks[i].id, 
-                   priorityToString(tasks[i].priority), 
-                   tasks[i].duration);
-            
-            printf("Press Enter to start execution...");
-            clearInputBuffer();
-            getchar();
-            
-            // Countdown timer
-            for (int j = tasks[i].duration; j > 0; j--) {
-                printf("\rTime remaining: %d seconds...   ", j);
-                fflush(stdout);
-                sleep(1);  // Simulate execution
-            }
-            
-            tasks[i].completed = true;
-            printf("\rTask %d completed!                  \n", tasks[i].id);
-            saveTasksToFile();
-            return;
-        } else if (tasks[i].id == id && tasks[i].completed) {
-            printf("Task %d is already marked as completed.\n", id);
+    generateSyntheticTasks(count);
+    for (int f = 0; f < RECORD_FORMAT_COUNT; f++) {
+        FILE *out = fopen(paths[f], "wb");
+        if (out == NULL) {
+            printf("Error: Cannot open %s for writing.\n", paths[f]);
+            free(buffer);
+            resetTaskStore();
             return;
         }
+        setvbuf(out, NULL, _IOFBF, STREAM_BUFFER_SIZE);
+        double start = monotonicSeconds();
+        exportTasks(out, (RecordFormat)f);
+        bytes[f] = (long long)ftell(out);
+        fclose(out);
+        exportTime[f] = monotonicSeconds() - start;
+    }
+    
+    FILE *savedJournal = journalFile;
+    int savedRecords = journalRecords;
+    printf("\n=== Import/Export Benchmark (%d tasks) ===\n", count);
+    for (int f = 0; f < RECORD_FORMAT_COUNT; f++) {
+        // What the disk (here, the page cache) delivers to a plain reader
+        FILE *in = fopen(paths[f], "rb");
+        double start = monotonicSeconds();
+        while (in != NULL && fread(buffer, 1, STREAM_BUFFER_SIZE, in) == STREAM_BUFFER_SIZE);
+        readTime[f] = monotonicSeconds() - start;
+        
+        // Parsing alone, without adding the tasks
+        parseTime[f] = 0;
+        RecordReader reader;
+        if (in != NULL && readerInit(&reader, in)) {
+            rewind(in);
+            start = monotonicSeconds();
+            Task t;
+            const char *error;
+            while (nextRecord(&reader, (RecordFormat)f, &t, &error) != 0);
+            parseTime[f] = monotonicSeconds() - start;
+            readerFree(&reader);
+        }
+        
+        resetTaskStore();
+        journalFile = fopen(journalPath, "wb");
+        journalRecords = 0;
+        if (in == NULL || journalFile == NULL) {
+            printf("Error: Cannot open %s.\n", in == NULL ? paths[f] : journalPath);
+            imported[f] = 0;
+            importTime[f] = 0;
+        } else {
+            rewind(in);
+            start = monotonicSeconds();
+            importTasks(in, paths[f], (RecordFormat)f, true);
+            importTime[f] = monotonicSeconds() - start;
+            imported[f] = taskCount;
+        }
+        if (in != NULL) {
+            fclose(in);
+        }
+        if (journalFile != NULL) {
+            fclose(journalFile);
+        }
     }
+    journalFile = savedJournal;
+    journalRecords = savedRecords;
     
-    printf("Task with ID %d not found.\n", id);
+    printf("\n%-7s %10s %12s %12s %12s %12s %12s %8s\n", "Format", "size", "export MB/s", "parse MB/s",
+           "import MB/s", "import/s", "read MB/s", "tasks");
+    for (int f = 0; f < RECORD_FORMAT_COUNT; f++) {
+        char size[32];
+        formatBytes((size_t)bytes[f], size, sizeof(size));
+        double megabytes = bytes[f] / 1e6;
+        printf("%-7s %10s %12.0f %12.0f %12.0f %12.0f %12.0f %8s\n", recordFormatNames[f], size, megabytes / exportTime[f],
+               parseTime[f] > 0 ? megabytes / parseTime[f] : 0.0, importTime[f] > 0 ? megabytes / importTime[f] : 0.0,
+               importTime[f] > 0 ? imported[f] / importTime[f] : 0.0,
+               readTime[f] > 0 ? megabytes / readTime[f] : 0.0, imported[f] == count ? "all" : "MISSING");
+        remove(paths[f]);
+    }
+    printf("Import reads through one %d KiB buffer and one record at a time, whatever the file size.\n",
+           STREAM_BUFFER_SIZE / 1024);
+    remove(journalPath);
+    free(buffer);
+    resetTaskStore();
 }
 
-// Execute all pending tasks in order
-void executeTasks() {
-    printf("\n=== Execute Tasks ===\n");
-    printf("1. Execute all tasks in sequence\n");
-    printf("2. Execute multiple tasks simultaneously\n");
-    printf("3. Execute a specific task\n");
-    printf("4. Return to main menu\n");
-    printf("Choice: ");
+// Entry point for `task_manager bench <name> [tasks]`
+int runBenchmark(int argc, char *argv[]) {
+    if (argc < 1) {
+        printf("Usage: task_manager bench lookup|sort|search|substring|startup|scan|strings|executor|plan|dag|timer|simulate|completions|commit|import|formats [tasks]\n");
+        return 1;
+    }
     
-    int choice;
-    scanf("%d", &choice);
+    // The executor benchmarks really sleep, so they default to fewer tasks
+    bool sleeps = strcmp(argv[0], "executor") == 0 || strcmp(argv[0], "dag") == 0;
+    bool timer = strcmp(argv[0], "timer") == 0;
+    bool stress = strcmp(argv[0], "completions") == 0 || strcmp(argv[0], "commit") == 0;
+    int count = argc > 1 ? atoi(argv[1]) : sleeps ? 2000 : timer || stress ? 100000 : 1000000;
+    if (count < 1) {
+        printf("Task count must be positive.\n");
+        return 1;
+    }
     
-    switch (choice) {
-        case 1: {
-            if (taskCount == 0) {
-                printf("\nNo tasks to execute.\n");
-                return;
-            }
-            
-            // Count pending tasks
-            int pendingCount = 0;
-            for (int i = 0; i < taskCount; i++) {
-                if (!tasks[i].completed) {
-                    pendingCount++;
-                }
-            }
-            
-            if (pendingCount == 0) {
-                printf("\nNo pending tasks to execute.\n");
-                return;
-            }
-
-            // Sort by priority first
-            for (int i = 0; i < taskCount - 1; i++) {
-                for (int j = i + 1; j < taskCount; j++) {
-                    if (tasks[i].priority > tasks[j].priority || 
-                       (tasks[i].priority == tasks[j].priority && tasks[i].duration > tasks[j].duration)) {
-                        Task temp = tasks[i];
-                        tasks[i] = tasks[j];
-                        tasks[j] = temp;
-                    }
-                }
-            }
-
-            printf("\n=== Executing %d Pending Tasks in Sequence ===\n", pendingCount);
-            printf("Tasks will be executed in priority order (highest first).\n");
-            
-            // Calculate total estimated time
-            int totalTime = 0;
-            for (int i = 0; i < taskCount; i++) {
-                if (!tasks[i].completed) {
-                    totalTime += tasks[i].duration;
-                }
-            }
-            printf("Total estimated time: %d seconds\n\n", totalTime);
-            
-            printf("Press Enter to start execution or Ctrl+C to cancel...");
-            clearInputBuffer();
-            getchar();
-            
-            int executed = 0;
-            time_t startTime = time(NULL);
-            
-            for (int i = 0; i < taskCount; i++) {
-                if (!tasks[i].completed) {
-                    printf("\n[%d/%d] Executing: %s (ID: %d) | Priority: %s | Duration: %d sec\n",
-                           executed + 1, pendingCount, tasks[i].description, tasks[i].id, 
-                           priorityToString(tasks[i].priority), tasks[i].duration);
-                    
-                    // Countdown timer
-                    for (int j = tasks[i].duration; j > 0; j--) {
-                        printf("\rTime remaining: %d seconds...   ", j);
-                        fflush(stdout);
-                        sleep(1);  // Simulate execution
-                    }
-                    
-                    tasks[i].completed = true;
-                    executed++;
-                    printf("\rTask %d completed!                  \n", tasks[i].id);
-                }
-            }
-            
-            time_t endTime = time(NULL);
-            printf("\n=== Execution Summary ===\n");
-            printf("Tasks completed: %d\n", executed);
-            printf("Total wall clock time: %ld seconds\n", (endTime - startTime));
-            
-            saveTasksToFile();
-            break;
-        }
-        case 2:
-            executeMultipleTasks();
-            break;
-        case 3:
-            executeSpecificTask();
-            break;
-        case 4:
-            return;
-        default:
-            printf("Invalid choice.\n");
+    if (strcmp(argv[0], "lookup") == 0) {
+        runLookupBenchmark(count);
+    } else if (strcmp(argv[0], "sort") == 0) {
+        runSortBenchmark(count);
+    } else if (strcmp(argv[0], "search") == 0) {
+        runSearchBenchmark(count);
+    } else if (strcmp(argv[0], "substring") == 0) {
+        runSubstringBenchmark(count);
+    } else if (strcmp(argv[0], "startup") == 0) {
+        runStartupBenchmark(count);
+    } else if (strcmp(argv[0], "scan") == 0) {
+        runScanBenchmark(count);
+    } else if (strcmp(argv[0], "strings") == 0) {
+        runStringBenchmark(count);
+    } else if (strcmp(argv[0], "executor") == 0) {
+        runExecutorBenchmark(count);
+    } else if (strcmp(argv[0], "plan") == 0) {
+        runPlanBenchmark(count);
+    } else if (strcmp(argv[0], "dag") == 0) {
+        runDagBenchmark(count);
+    } else if (timer) {
+        runTimerBenchmark(count);
+    } else if (strcmp(argv[0], "simulate") == 0) {
+        runSimulateBenchmark(count);
+    } else if (strcmp(argv[0], "completions") == 0) {
+        runCompletionBenchmark(count);
+    } else if (strcmp(argv[0], "commit") == 0) {
+        runCommitBenchmark(count);
+    } else if (strcmp(argv[0], "import") == 0) {
+        runImportBenchmark(count);
+    } else if (strcmp(argv[0], "formats") == 0) {
+        runFormatBenchmark(count);
+    } else {
+        printf("Unknown benchmark '%s'.\n", argv[0]);
+        return 1;
     }
+    return 0;
 }
 
 // Show the main menu and get user's choice
@@ -918,12 +9631,20 @@ void showMenu() {
     printf("║ 5. Modify Task                     ║\n");
     printf("║ 6. Sort Tasks                      ║\n");
     printf("║ 7. Execute Tasks                   ║\n");
-    printf("║ 8. Exit                           ║\n");
+    printf("║ 8. Exit                            ║\n");
+    printf("║ 9. Storage Report                  ║\n");
     printf("╚════════════════════════════════════╝\n");
-    printf("Enter your choice (1-8): ");
+    printf("Enter your choice (1-9): ");
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return runBenchmark(argc - 2, argv + 2);
+    }
+    if (argc > 1 && isCommand(argv[1])) {
+        return runCommandLine(argc - 1, argv + 1);
+    }
+    
     printf("Task Manager System\n");
     printf("===================\n");
     
@@ -957,12 +9678,24 @@ int main() {
                 executeTasks();
                 break;
             case 8:
+                // Fold the journal into tasks.dat before leaving
+                if (journalRecords > 0) {
+                    saveTasksToFile();
+                }
                 printf("\nExiting Task Manager. Goodbye!\n");
                 break;
+            case 9:
+                showStorageReport();
+                break;
             default:
                 printf("\nInvalid choice. Please try again.\n");
         }
     } while (choice != 8);
     
+    stopExecutor();
+    if (journalFile != NULL) {
+        fclose(journalFile);
+    }
+    resetTaskStore();
     return 0;
 }
\ No newline at end of file